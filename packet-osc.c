@@ -29,6 +29,8 @@
 
 #include "config.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
@@ -36,6 +38,12 @@
 #include <epan/prefs.h>
 #include <epan/conversation.h>
 #include <epan/exceptions.h>
+#include <epan/expert.h>
+#include <epan/tap.h>
+#include <epan/stats_tree.h>
+#include <epan/uat.h>
+#include <epan/exported_pdu.h>
+#include <epan/stat_cmd_args.h>
 //#include "packet-tcp.h"
 
 void proto_register_osc(void);
@@ -60,7 +68,10 @@ typedef enum _OSC_Type {
     OSC_SYMBOL  = 'S',
     OSC_CHAR    = 'c',
     OSC_RGBA    = 'r',
-    OSC_MIDI    = 'm'
+    OSC_MIDI    = 'm',
+
+    OSC_ARRAY_BEGIN = '[',
+    OSC_ARRAY_END   = ']'
 } OSC_Type;
 
 /* characters not allowed in OSC path string */
@@ -75,6 +86,14 @@ static const char valid_format_chars [] = {
     OSC_TRUE,   OSC_FALSE,  OSC_NIL,     OSC_BANG,
     OSC_INT64,  OSC_DOUBLE, OSC_TIMETAG,
     OSC_SYMBOL, OSC_CHAR,   OSC_RGBA,    OSC_MIDI,
+    OSC_ARRAY_BEGIN, OSC_ARRAY_END,
+    '\0'
+};
+
+/* format characters without argument data */
+static const char empty_format_chars [] = {
+    OSC_TRUE,   OSC_FALSE,  OSC_NIL,     OSC_BANG,
+    OSC_ARRAY_BEGIN, OSC_ARRAY_END,
     '\0'
 };
 
@@ -185,17 +204,361 @@ static const value_string MIDI_control [] = {
 };
 static value_string_ext MIDI_control_ext = VALUE_STRING_EXT_INIT(MIDI_control);
 
+/* direct lookup of MIDI names for labels, filled from the tables above */
+static const gchar *MIDI_status_names [256];
+static const gchar *MIDI_control_names [256];
+
+static void
+osc_init_midi_names(void)
+{
+    const value_string *vs;
+    guint               i;
+
+    for(i = 0; i < 256; i++)
+    {
+        MIDI_status_names[i] = "Unknown";
+        MIDI_control_names[i] = "Unknown";
+    }
+
+    for(vs = MIDI_status; vs->strptr; vs++)
+        MIDI_status_names[vs->value] = vs->strptr;
+    for(vs = MIDI_control; vs->strptr; vs++)
+        MIDI_control_names[vs->value] = vs->strptr;
+}
+
+/* label of a MIDI argument, only formatted when the item is displayed */
+static void
+osc_fmt_midi(gchar *result, guint32 value)
+{
+    guint8 channel = (value >> 24) & 0xff;
+    guint8 status  = (value >> 16) & 0xff;
+    guint8 data1   = (value >> 8) & 0xff;
+    guint8 data2   = value & 0xff;
+
+    if(status == MIDI_STATUS_CONTROLLER) /* MIDI Controller */
+        g_snprintf(result, ITEM_LABEL_LENGTH, "Channel %2i, %s (0x%02x), %s (0x%02x), 0x%02x",
+                channel,
+                MIDI_status_names[status], status,
+                MIDI_control_names[data1], data1,
+                data2);
+    else
+        g_snprintf(result, ITEM_LABEL_LENGTH, "Channel %2i, %s (0x%02x), 0x%02x, 0x%02x",
+                channel,
+                MIDI_status_names[status], status,
+                data1, data2);
+}
+
+/* label of a blob size, only formatted when the item is displayed */
+static void
+osc_fmt_blob_size(gchar *result, guint32 value)
+{
+    g_snprintf(result, ITEM_LABEL_LENGTH, "%i bytes", (gint32)value);
+}
+
 static const char *immediate_fmt = "%s";
 static const char *immediate_str = "Immediate";
 static const char *bundle_str = "#bundle";
 
 /* Preference */
-static guint global_osc_tcp_port = 0;
+static guint    global_osc_tcp_port = 0;
+static gboolean global_osc_dup_detect = FALSE;
+static guint    global_osc_dup_window = 16;
+static guint    global_osc_dup_interval = 50;
+static guint    global_osc_seq_resync = 256;
+
+/* upper bound of the duplicate window preference, it is scanned for every PDU */
+#define OSC_DUP_MAX_WINDOW 256
+static gboolean global_osc_value_analysis = FALSE;
+static gboolean global_osc_namespace = FALSE;
+static guint    global_osc_bundle_window = 10;
+static guint    global_osc_blob_max_bytes = 1024;
+static guint    global_osc_string_max_len = 4096;
+static gint     global_osc_sampling = 0;
+static guint    global_osc_sampling_count = 10;
+static guint    global_osc_sampling_interval = 100;
+static guint    global_osc_heur_threshold = 3;
+static guint    global_osc_heur_max_failures = 5;
+static gboolean global_osc_perf = FALSE;
+static guint    global_osc_ws_port = 0;
+static guint    global_osc_array_max_depth = 8;
+static gboolean global_osc_unknown_tags = FALSE;
+
+/* size of the array stack of the message walker, bounds the depth preference */
+#define OSC_ARRAY_MAX_DEPTH 32
+
+/* maximal bundle nesting accepted by the structure check */
+#define OSC_CHECK_MAX_DEPTH 16
+
+/* Structure check results */
+typedef enum _osc_check_t {
+    OSC_CHECK_OK,
+    OSC_CHECK_ELEMENT,
+    OSC_CHECK_PATH,
+    OSC_CHECK_FORMAT,
+    OSC_CHECK_STRING,
+    OSC_CHECK_BLOB,
+    OSC_CHECK_BUNDLE,
+    OSC_CHECK_SIZE,
+    OSC_CHECK_EXCEPTION,
+    OSC_CHECK_N
+} osc_check_t;
+
+static const value_string osc_check_vals[] = {
+    { OSC_CHECK_OK,        "Accepted" },
+    { OSC_CHECK_ELEMENT,   "Rejected: neither message nor bundle" },
+    { OSC_CHECK_PATH,      "Rejected: invalid path" },
+    { OSC_CHECK_FORMAT,    "Rejected: invalid format" },
+    { OSC_CHECK_STRING,    "Rejected: unterminated string" },
+    { OSC_CHECK_BLOB,      "Rejected: invalid blob size" },
+    { OSC_CHECK_BUNDLE,    "Rejected: invalid bundle header" },
+    { OSC_CHECK_SIZE,      "Rejected: size mismatch" },
+    { OSC_CHECK_EXCEPTION, "Rejected: truncated" },
+
+    { 0, NULL }
+};
+
+/* Instrumented entry points */
+typedef enum _osc_perf_entry_t {
+    OSC_PERF_UDP,
+    OSC_PERF_TCP,
+    OSC_PERF_HEUR_UDP,
+    OSC_PERF_WS,
+    OSC_PERF_HEUR_WS,
+    OSC_PERF_N
+} osc_perf_entry_t;
+
+static const value_string osc_perf_entry_vals[] = {
+    { OSC_PERF_UDP,      "dissect_osc_udp" },
+    { OSC_PERF_TCP,      "dissect_osc_tcp" },
+    { OSC_PERF_HEUR_UDP, "dissect_osc_heur_udp" },
+    { OSC_PERF_WS,       "dissect_osc_ws" },
+    { OSC_PERF_HEUR_WS,  "dissect_osc_heur_ws" },
+
+    { 0, NULL }
+};
+
+/* Sampling modes */
+enum {
+    OSC_SAMPLING_OFF,
+    OSC_SAMPLING_COUNT,
+    OSC_SAMPLING_INTERVAL
+};
+
+static const enum_val_t osc_sampling_vals[] = {
+    { "off", "Dissect every message", OSC_SAMPLING_OFF },
+    { "count", "Dissect every Nth message per path", OSC_SAMPLING_COUNT },
+    { "interval", "Dissect one message per interval per path", OSC_SAMPLING_INTERVAL },
+    { NULL, NULL, 0 }
+};
+
+/* maximal number of numeric arguments per message considered for value deltas */
+#define OSC_VALUE_MAX_ARGS 16
+
+/* open sequence gaps remembered per path, late messages outside of them count as duplicates */
+#define OSC_SEQ_MAX_GAPS 16
+
+/* Sequence number table entry */
+typedef struct _osc_seq_uat_t {
+    gchar *pattern;
+    guint  arg_index;
+} osc_seq_uat_t;
+
+static osc_seq_uat_t *osc_seq_uats = NULL;
+static guint          num_osc_seq_uats = 0;
+
+/* Sequence number lookup, rebuilt from the table: exact paths are hashed, patterns are matched in order */
+static GHashTable    *osc_seq_exact = NULL;
+static GPtrArray     *osc_seq_patterns = NULL;
+
+typedef struct _osc_seq_pattern_t {
+    GPatternSpec *spec;
+    guint         arg_index;
+} osc_seq_pattern_t;
+
+/* Duplicate detection window entry */
+typedef struct _osc_dup_entry_t {
+    guint64  hash;
+    guint32  len;
+    guint32  frame;
+    nstime_t ts;
+} osc_dup_entry_t;
+
+/* Per conversation state, built during the first pass */
+typedef struct _osc_conv_info_t {
+    gchar           *label;
+    guint            heur_score;
+    guint            heur_failures;
+    gboolean         heur_bound;
+    guint32          heur_bound_frame;
+    guint32          heur_release_frame;
+    gboolean         ws_bound;
+    guint32          ws_bound_frame;
+    address          src;
+    guint32          srcport;
+    gboolean         has_last_ts[2];
+    nstime_t         last_ts[2];
+    guint32          last_frame[2];
+    osc_dup_entry_t *dup_window[2];
+    guint            dup_size;
+    guint            dup_pos[2];
+    wmem_tree_t     *paths;
+} osc_conv_info_t;
+
+/* Range of sequence numbers counted as lost and not received since */
+typedef struct _osc_seq_gap_t {
+    gint64           start;
+    guint32          count;
+} osc_seq_gap_t;
+
+/* Per conversation and path state, built during the first pass */
+typedef struct _osc_path_info_t {
+    /* sequence number tracking */
+    gboolean         seq_resolved;
+    gint             seq_arg;
+    gboolean         has_seq;
+    gint64           seq_next;
+    osc_seq_gap_t    seq_gaps[OSC_SEQ_MAX_GAPS]; /* oldest first */
+    guint            seq_n_gaps;
+
+    /* sampling */
+    guint            sample_count;
+    gboolean         has_sample_ts;
+    nstime_t         sample_ts;
+    guint32          sample_skipped;
+
+    /* last argument vector, for value change analysis */
+    gboolean         has_last;
+    guint64          last_hash;
+    gint             last_len;
+    guint            last_n_values;
+    gdouble          last_values[OSC_VALUE_MAX_ARGS];
+} osc_path_info_t;
+
+/* Numeric argument range of a namespace signature */
+typedef struct _osc_ns_range_t {
+    gdouble          min;
+    gdouble          max;
+} osc_ns_range_t;
+
+/* Type signature seen at a namespace node */
+typedef struct _osc_ns_signature_t {
+    const gchar     *format;
+    guint32          count;
+    guint32          last_frame;
+    gboolean         has_values;
+    guint            n_values;
+    osc_ns_range_t   ranges[OSC_VALUE_MAX_ARGS];
+} osc_ns_signature_t;
+
+/* Node of the capture wide address namespace, one per path segment, built during the first pass */
+typedef struct _osc_ns_node_t {
+    const gchar     *name;
+    wmem_tree_t     *children;   /* segment -> osc_ns_node_t */
+    wmem_tree_t     *signatures; /* format -> osc_ns_signature_t */
+    guint32          count;      /* messages addressed to exactly this node */
+    guint32          first_frame;
+    guint32          last_frame;
+} osc_ns_node_t;
+
+static osc_ns_node_t *osc_namespace = NULL;
+
+/* set by the namespace views, which collect it without the preference */
+static gboolean       osc_ns_requested = FALSE;
+
+/* Per message state, persisted across passes */
+typedef struct _osc_message_info_t {
+    gboolean         analysed;
+    gboolean         unchanged;
+    gboolean         has_delta;
+    gdouble          mean_delta;
+    gboolean         has_seq;
+    gint64           seq;
+    guint32          seq_lost;
+    gboolean         seq_reordered;
+    gboolean         seq_duplicate;
+    gboolean         seq_resync;
+    gboolean         sampled_out;
+    guint32          sample_skipped;
+    osc_ns_node_t   *ns_node;
+    osc_ns_signature_t *ns_signature;
+    wmem_array_t    *blob_hashes; /* guint64, one per blob exceeding the display limit */
+} osc_message_info_t;
+
+/* Per PDU state, persisted across passes */
+typedef struct _osc_pdu_info_t {
+    guint32          duplicate_of;
+    gboolean         bundleable;
+    wmem_array_t    *messages; /* osc_message_info_t * */
+} osc_pdu_info_t;
+
+/* Transient state while dissecting a single PDU */
+typedef struct _osc_ctx_t {
+    packet_info     *pinfo;
+    osc_conv_info_t *conv_info;
+    osc_pdu_info_t  *pdu_info;
+    guint            msg_index;
+    guint            depth;
+    guint            max_depth;
+    guint32          bundle_bytes;
+    guint32          elements; /* bundles, messages, arrays and arguments added to the tree */
+} osc_ctx_t;
+
+/* Tap record types */
+typedef enum _osc_tap_type_t {
+    OSC_TAP_PDU,
+    OSC_TAP_MESSAGE,
+    OSC_TAP_PERF
+} osc_tap_type_t;
+
+/* Tap record, queued once per PDU, once per message and once per instrumented entry point call */
+typedef struct _osc_tap_info_t {
+    osc_tap_type_t         type;
+    const osc_conv_info_t *conv;
+    guint32                len;
+
+    gboolean               bundleable;
+
+    /* OSC_TAP_PDU */
+    guint32                duplicate_of;
+    guint32                bundle_bytes;
+    guint32                elements;
+    guint                  max_depth;
+
+    /* OSC_TAP_MESSAGE */
+    const gchar           *path;
+    const osc_message_info_t *msg_info;
+    gboolean               bundled;
+    guint32                address_bytes;
+    guint32                typetag_bytes;
+    guint32                argument_bytes;
+    guint32                padding_bytes;
+
+    /* OSC_TAP_PERF */
+    osc_perf_entry_t       perf_entry;
+    gint64                 perf_usec;
+    osc_check_t            perf_check;
+} osc_tap_info_t;
+
+/* Packet scoped proto data key of the PDU counter */
+#define OSC_PDU_COUNTER_KEY 0
 
 /* Initialize the protocol and registered fields */
 static dissector_handle_t osc_udp_handle = NULL;
 
 static int proto_osc = -1;
+static int osc_tap = -1;
+static int exported_pdu_tap = -1;
+
+static int hf_osc_duplicate_of_type = -1;
+static int hf_osc_unchanged_type = -1;
+static int hf_osc_seq_type = -1;
+static int hf_osc_seq_lost_type = -1;
+static int hf_osc_seq_reordered_type = -1;
+static int hf_osc_seq_duplicate_type = -1;
+static int hf_osc_seq_resync_type = -1;
+static int hf_osc_sampling_skipped_type = -1;
+static int hf_osc_ns_first_frame_type = -1;
+static int hf_osc_ns_last_frame_type = -1;
 
 static int hf_osc_bundle_type = -1;
 static int hf_osc_message_type = -1;
@@ -215,6 +578,7 @@ static int hf_osc_message_float_type = -1;
 static int hf_osc_message_string_type = -1;
 static int hf_osc_message_blob_size_type = -1;
 static int hf_osc_message_blob_data_type = -1;
+static int hf_osc_message_blob_hash_type = -1;
 
 static int hf_osc_message_true_type = -1;
 static int hf_osc_message_false_type = -1;
@@ -239,6 +603,8 @@ static int hf_osc_message_midi_data1_type = -1;
 static int hf_osc_message_midi_data2_type = -1;
 static int hf_osc_message_midi_controller_type = -1;
 static int hf_osc_message_midi_value_type = -1;
+static int hf_osc_message_array_type = -1;
+static int hf_osc_message_undecoded_type = -1;
 
 /* Initialize the subtree pointers */
 static int ett_osc_packet = -1;
@@ -248,473 +614,2244 @@ static int ett_osc_message_header = -1;
 static int ett_osc_blob = -1;
 static int ett_osc_rgba = -1;
 static int ett_osc_midi = -1;
+static int ett_osc_array = -1;
+
+/* Initialize the expert fields */
+static expert_field ei_osc_duplicate = EI_INIT;
+static expert_field ei_osc_seq_gap = EI_INIT;
+static expert_field ei_osc_seq_reordered = EI_INIT;
+static expert_field ei_osc_seq_duplicate = EI_INIT;
+static expert_field ei_osc_seq_resync = EI_INIT;
+static expert_field ei_osc_blob_size = EI_INIT;
+static expert_field ei_osc_string_size = EI_INIT;
+static expert_field ei_osc_unknown_tag = EI_INIT;
+static expert_field ei_osc_string_limit = EI_INIT;
+
+/* 64bit FNV-1a hash over the captured part of a byte range */
+static guint64
+osc_hash(tvbuff_t *tvb, gint offset, gint len)
+{
+    const guint8 *ptr;
+    guint64       hash = G_GUINT64_CONSTANT(0xcbf29ce484222325);
+    gint          i;
 
-/* check for valid path string */
-static gboolean
-is_valid_path(const char *path)
+    len = MIN(len, tvb_captured_length_remaining(tvb, offset));
+    if(len <= 0)
+        return hash;
+
+    ptr = tvb_get_ptr(tvb, offset, len);
+    for(i=0; i<len; i++)
+    {
+        hash ^= ptr[i];
+        hash *= G_GUINT64_CONSTANT(0x100000001b3);
+    }
+    return hash;
+}
+
+/* get or create OSC state of current conversation */
+static osc_conv_info_t *
+get_osc_conv_info(packet_info *pinfo)
 {
-    const char *ptr;
-    if(path[0] != '/')
-        return FALSE;
-    for(ptr=path+1; *ptr!='\0'; ptr++)
-        if( (isprint(*ptr) == 0) || (strchr(invalid_path_chars, *ptr) != NULL) )
-            return FALSE;
-    return TRUE;
+    conversation_t  *conversation;
+    osc_conv_info_t *conv_info;
+
+    conversation = find_or_create_conversation(pinfo);
+    conv_info = (osc_conv_info_t *)conversation_get_proto_data(conversation, proto_osc);
+    if(!conv_info)
+    {
+        conv_info = wmem_new0(wmem_file_scope(), osc_conv_info_t);
+        conv_info->label = wmem_strdup_printf(wmem_file_scope(), "%s:%u <-> %s:%u",
+                ep_address_to_str(&pinfo->src), pinfo->srcport,
+                ep_address_to_str(&pinfo->dst), pinfo->destport);
+        WMEM_COPY_ADDRESS(wmem_file_scope(), &conv_info->src, &pinfo->src);
+        conv_info->srcport = pinfo->srcport;
+        conversation_add_proto_data(conversation, proto_osc, conv_info);
+    }
+    return conv_info;
 }
 
-/* check for valid format string */
+/* get OSC state of current conversation, without creating it */
+static osc_conv_info_t *
+find_osc_conv_info(packet_info *pinfo)
+{
+    conversation_t *conversation;
+
+    conversation = find_conversation(pinfo->fd->num, &pinfo->src, &pinfo->dst,
+                                     pinfo->ptype, pinfo->srcport, pinfo->destport, 0);
+    if(!conversation)
+        return NULL;
+
+    return (osc_conv_info_t *)conversation_get_proto_data(conversation, proto_osc);
+}
+
+/* direction of current packet within conversation, 0 for the first sender seen */
+static guint
+osc_conv_dir(osc_conv_info_t *conv_info, packet_info *pinfo)
+{
+    return (ADDRESSES_EQUAL(&pinfo->src, &conv_info->src) && (pinfo->srcport == conv_info->srcport)) ? 0 : 1;
+}
+
+/* check whether PDU follows the previous one of the same sender closely enough to have shared its datagram */
 static gboolean
-is_valid_format(const char *format)
+osc_bundle_check(osc_conv_info_t *conv_info, packet_info *pinfo)
 {
-    const char *ptr;
-    if(format[0] != ',')
+    nstime_t delta;
+    gboolean bundleable = FALSE;
+    guint    dir;
+
+    dir = osc_conv_dir(conv_info, pinfo);
+
+    /* PDUs reassembled from the same frame (TCP, WebSocket) already share one segment */
+    if(conv_info->has_last_ts[dir] && (conv_info->last_frame[dir] == pinfo->fd->num))
         return FALSE;
-    for(ptr=format+1; *ptr!='\0'; ptr++)
-        if(strchr(valid_format_chars, *ptr) == NULL)
-            return FALSE;
-    return TRUE;
+
+    if(conv_info->has_last_ts[dir])
+    {
+        nstime_delta(&delta, &pinfo->fd->abs_ts, &conv_info->last_ts[dir]);
+        bundleable = nstime_to_msec(&delta) <= global_osc_bundle_window;
+    }
+
+    conv_info->has_last_ts[dir] = TRUE;
+    conv_info->last_ts[dir] = pinfo->fd->abs_ts;
+    conv_info->last_frame[dir] = pinfo->fd->num;
+
+    return bundleable;
 }
 
-/* Dissect OSC message */
-static int
-dissect_osc_message(tvbuff_t *tvb, proto_item *ti, proto_tree *osc_tree, gint offset, gint len)
+/* look up PDU in duplicate window of conversation and insert it */
+static guint32
+osc_dup_check(osc_conv_info_t *conv_info, packet_info *pinfo, guint64 hash, guint32 len)
 {
-    proto_tree  *message_tree;
-    proto_tree  *header_tree;
-    gint         slen;
-    gint         rem;
-    gint         end = offset + len;
-    const gchar *path;
-    gint         path_len;
-    gint         path_offset;
-    const gchar *format;
-    gint         format_offset;
-    gint         format_len;
-    const gchar *ptr;
+    osc_dup_entry_t *window;
+    osc_dup_entry_t *entry;
+    nstime_t         delta;
+    guint            dir;
+    guint            i;
+
+    if(!conv_info->dup_size)
+        conv_info->dup_size = MIN(global_osc_dup_window, OSC_DUP_MAX_WINDOW);
+
+    /* only repeats by the same sender count, replies and echoes go the other way */
+    dir = osc_conv_dir(conv_info, pinfo);
+    if(!conv_info->dup_window[dir])
+        conv_info->dup_window[dir] = wmem_alloc0_array(wmem_file_scope(), osc_dup_entry_t, conv_info->dup_size);
+    window = conv_info->dup_window[dir];
+
+    for(i=0; i<conv_info->dup_size; i++)
+    {
+        entry = &window[i];
+        if( (entry->frame == 0) || (entry->hash != hash) || (entry->len != len) )
+            continue;
 
-    /* peek/read path */
-    path_offset = offset;
-    path = tvb_get_const_stringz(tvb, path_offset, &path_len);
-    if( (rem = path_len%4) ) path_len += 4-rem;
+        /* legitimate repeats (heartbeats, unchanged values) are further apart than redundant sends */
+        nstime_delta(&delta, &pinfo->fd->abs_ts, &entry->ts);
+        if(nstime_to_msec(&delta) <= global_osc_dup_interval)
+            return entry->frame;
+    }
 
-    if(!is_valid_path(path))
-        return -1;
+    entry = &window[conv_info->dup_pos[dir]];
+    entry->hash = hash;
+    entry->len = len;
+    entry->frame = pinfo->fd->num;
+    entry->ts = pinfo->fd->abs_ts;
+    conv_info->dup_pos[dir] = (conv_info->dup_pos[dir] + 1) % conv_info->dup_size;
 
-    /* peek/read fmt */
-    format_offset = path_offset + path_len;
-    format = tvb_get_const_stringz(tvb, format_offset, &format_len);
-    if( (rem = format_len%4) ) format_len += 4-rem;
+    return 0;
+}
 
-    if(!is_valid_format(format))
-        return -1;
+/* get per PDU state, creating it during the first pass */
+static osc_pdu_info_t *
+get_osc_pdu_info(tvbuff_t *tvb, packet_info *pinfo, osc_conv_info_t *conv_info, gint offset, gint len)
+{
+    guint32        *counter;
+    guint32         key;
+    osc_pdu_info_t *pdu_info;
 
-    /* create message */
-    ti = proto_tree_add_none_format(osc_tree, hf_osc_message_type, tvb, offset, len, "Message: %s %s", path, format);
-    message_tree = proto_item_add_subtree(ti, ett_osc_message);
+    /* a frame may carry multiple PDUs, number them in order of appearance */
+    counter = (guint32 *)p_get_proto_data(pinfo->pool, pinfo, proto_osc, OSC_PDU_COUNTER_KEY);
+    if(!counter)
+    {
+        counter = wmem_new0(pinfo->pool, guint32);
+        p_add_proto_data(pinfo->pool, pinfo, proto_osc, OSC_PDU_COUNTER_KEY, counter);
+    }
+    key = (*counter)++;
 
-    /* append header */
-    ti = proto_tree_add_item(message_tree, hf_osc_message_header_type, tvb, offset, path_len+format_len, ENC_NA);
-    header_tree = proto_item_add_subtree(ti, ett_osc_message_header);
+    pdu_info = (osc_pdu_info_t *)p_get_proto_data(wmem_file_scope(), pinfo, proto_osc, key);
+    if(!pdu_info)
+    {
+        pdu_info = wmem_new0(wmem_file_scope(), osc_pdu_info_t);
+        if(global_osc_dup_detect && (global_osc_dup_window > 0) && !pinfo->fd->flags.visited)
+            pdu_info->duplicate_of = osc_dup_check(conv_info, pinfo, osc_hash(tvb, offset, len), len);
+        if( (global_osc_bundle_window > 0) && !pinfo->fd->flags.visited)
+            pdu_info->bundleable = osc_bundle_check(conv_info, pinfo);
+        p_add_proto_data(wmem_file_scope(), pinfo, proto_osc, key, pdu_info);
+    }
+    return pdu_info;
+}
 
-    /* append path */
-    proto_tree_add_item(header_tree, hf_osc_message_path_type, tvb, path_offset, path_len, ENC_ASCII | ENC_NA);
+/* get or create state of path within conversation */
+static osc_path_info_t *
+get_osc_path_info(osc_conv_info_t *conv_info, const gchar *path)
+{
+    osc_path_info_t *path_info;
 
-    /* append format */
-    proto_tree_add_item(header_tree, hf_osc_message_format_type, tvb, format_offset, format_len, ENC_ASCII | ENC_NA);
+    if(!conv_info->paths)
+        conv_info->paths = wmem_tree_new(wmem_file_scope());
 
-    offset += path_len + format_len;
+    path_info = (osc_path_info_t *)wmem_tree_lookup_string(conv_info->paths, path, 0);
+    if(!path_info)
+    {
+        path_info = wmem_new0(wmem_file_scope(), osc_path_info_t);
+        wmem_tree_insert_string(conv_info->paths, path, path_info, 0);
+    }
+    return path_info;
+}
 
-    /* ::parse argument:: */
-    ptr = format + 1; /* skip ',' */
-    while( (*ptr != '\0') && (offset < end) )
+/* Address namespace */
+
+static void
+osc_namespace_init(void)
+{
+    /* the nodes themselves are file scoped */
+    osc_namespace = NULL;
+}
+
+/* add path to the namespace, one lookup per segment, shared prefixes are shared nodes */
+static osc_ns_node_t *
+osc_ns_insert(const gchar *path, guint32 frame)
+{
+    osc_ns_node_t *node;
+    osc_ns_node_t *child;
+    gchar         *segment;
+    gchar         *next;
+
+    if(!osc_namespace)
+        osc_namespace = wmem_new0(wmem_file_scope(), osc_ns_node_t);
+    node = osc_namespace;
+
+    /* split a copy of the path in place */
+    segment = wmem_strdup(wmem_packet_scope(), path + 1); /* skip leading '/' */
+    for(;;)
     {
-        switch(*ptr)
+        if( (next = strchr(segment, '/')) )
+            *next = '\0';
+
+        if(!node->children)
+            node->children = wmem_tree_new(wmem_file_scope());
+        child = (osc_ns_node_t *)wmem_tree_lookup_string(node->children, segment, 0);
+        if(!child)
         {
-            case OSC_INT32:
-                proto_tree_add_item(message_tree, hf_osc_message_int32_type, tvb, offset, 4, ENC_BIG_ENDIAN);
-                offset += 4;
-                break;
-            case OSC_FLOAT:
-                proto_tree_add_item(message_tree, hf_osc_message_float_type, tvb, offset, 4, ENC_BIG_ENDIAN);
-                offset += 4;
-                break;
-            case OSC_STRING:
-                slen = tvb_strsize(tvb, offset);
-                if( (rem = slen%4) ) slen += 4-rem;
-                proto_tree_add_item(message_tree, hf_osc_message_string_type, tvb, offset, slen, ENC_ASCII | ENC_NA);
-                offset += slen;
-                break;
-            case OSC_BLOB:
-            {
-                proto_item *bi;
-                proto_tree *blob_tree;
+            child = wmem_new0(wmem_file_scope(), osc_ns_node_t);
+            child->name = wmem_strdup(wmem_file_scope(), segment);
+            wmem_tree_insert_string(node->children, segment, child, 0);
+        }
+        node = child;
 
-                gint32 blen = tvb_get_ntohl(tvb, offset);
-                slen = blen;
-                if( (rem = slen%4) ) slen += 4-rem;
+        if(!next)
+            break;
+        segment = next + 1;
+    }
 
-                bi = proto_tree_add_none_format(message_tree, hf_osc_message_blob_type, tvb, offset, 4+slen, "Blob: %i bytes", blen);
-                blob_tree = proto_item_add_subtree(bi, ett_osc_blob);
+    if(node->count++ == 0)
+        node->first_frame = frame;
+    node->last_frame = frame;
 
-                proto_tree_add_int_format_value(blob_tree, hf_osc_message_blob_size_type, tvb, offset, 4, blen, "%i bytes", blen);
-                offset += 4;
+    return node;
+}
 
-                /* check for zero length blob */
-                if(blen == 0)
-                    break;
+/* account type signature of a message addressed to a namespace node */
+static osc_ns_signature_t *
+osc_ns_signature(osc_ns_node_t *node, const gchar *format, guint32 frame)
+{
+    osc_ns_signature_t *sig;
 
-                proto_tree_add_item(blob_tree, hf_osc_message_blob_data_type, tvb, offset, slen, ENC_NA);
-                offset += slen;
-                break;
-            }
+    if(!node->signatures)
+        node->signatures = wmem_tree_new(wmem_file_scope());
+    sig = (osc_ns_signature_t *)wmem_tree_lookup_string(node->signatures, format, 0);
+    if(!sig)
+    {
+        sig = wmem_new0(wmem_file_scope(), osc_ns_signature_t);
+        sig->format = wmem_strdup(wmem_file_scope(), format);
+        wmem_tree_insert_string(node->signatures, format, sig, 0);
+    }
+    sig->count++;
+    sig->last_frame = frame;
 
-            case OSC_TRUE:
-                proto_tree_add_item(message_tree, hf_osc_message_true_type, tvb, offset, 0, ENC_NA);
-                break;
-            case OSC_FALSE:
-                proto_tree_add_item(message_tree, hf_osc_message_false_type, tvb, offset, 0, ENC_NA);
-                break;
-            case OSC_NIL:
-                proto_tree_add_item(message_tree, hf_osc_message_nil_type, tvb, offset, 0, ENC_NA);
-                break;
-            case OSC_BANG:
-                proto_tree_add_item(message_tree, hf_osc_message_bang_type, tvb, offset, 0, ENC_NA);
-                break;
+    return sig;
+}
 
-            case OSC_INT64:
-                proto_tree_add_item(message_tree, hf_osc_message_int64_type, tvb, offset, 8, ENC_BIG_ENDIAN);
-                offset += 8;
-                break;
-            case OSC_DOUBLE:
-                proto_tree_add_item(message_tree, hf_osc_message_double_type, tvb, offset, 8, ENC_BIG_ENDIAN);
-                offset += 8;
-                break;
-            case OSC_TIMETAG:
-            {
-                guint32  sec  = tvb_get_ntohl(tvb, offset);
-                guint32  frac = tvb_get_ntohl(tvb, offset+4);
-                nstime_t ns;
-                if( (sec == 0) && (frac == 1) )
-                    proto_tree_add_time_format_value(message_tree, hf_osc_message_timetag_type, tvb, offset, 8, &ns, immediate_fmt, immediate_str);
-                else
-                    proto_tree_add_item(message_tree, hf_osc_message_timetag_type, tvb, offset, 8, ENC_TIME_NTP | ENC_BIG_ENDIAN);
-                offset += 8;
-            }
-                break;
+/* widen numeric argument ranges of a signature */
+static void
+osc_ns_ranges(osc_ns_signature_t *sig, const gdouble *values, guint n_values)
+{
+    guint i;
 
-            case OSC_SYMBOL:
-                slen = tvb_strsize(tvb, offset);
-                if( (rem = slen%4) ) slen += 4-rem;
-                proto_tree_add_item(message_tree, hf_osc_message_symbol_type, tvb, offset, slen, ENC_ASCII | ENC_NA);
-                offset += slen;
-                break;
-            case OSC_CHAR:
-                offset += 3;
-                proto_tree_add_item(message_tree, hf_osc_message_char_type, tvb, offset, 1, ENC_ASCII | ENC_NA);
-                offset += 1;
-                break;
-            case OSC_RGBA:
-            {
-                proto_item *ri;
-                proto_tree *rgba_tree;
+    if(!sig->has_values)
+    {
+        sig->has_values = TRUE;
+        sig->n_values = n_values;
+        for(i=0; i<n_values; i++)
+            sig->ranges[i].min = sig->ranges[i].max = values[i];
+        return;
+    }
 
-                ri = proto_tree_add_item(message_tree, hf_osc_message_rgba_type, tvb, offset, 4, ENC_BIG_ENDIAN);
-                rgba_tree = proto_item_add_subtree(ri, ett_osc_rgba);
+    for(i=0; i<MIN(n_values, sig->n_values); i++)
+    {
+        if(values[i] < sig->ranges[i].min)
+            sig->ranges[i].min = values[i];
+        if(values[i] > sig->ranges[i].max)
+            sig->ranges[i].max = values[i];
+    }
+}
 
-                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_red_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
-                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_green_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
-                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_blue_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
-                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_alpha_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
-                break;
-            }
-            case OSC_MIDI:
-            {
-                const gchar *status_str;
-                proto_item  *mi = NULL;
-                proto_tree  *midi_tree;
-                guint8       channel;
-                guint8       status;
-                guint8       data1;
-                guint8       data2;
+/* Sequence number table */
+
+UAT_CSTRING_CB_DEF(osc_seq_uats, pattern, osc_seq_uat_t)
+UAT_DEC_CB_DEF(osc_seq_uats, arg_index, osc_seq_uat_t)
+
+static void *
+osc_seq_uat_copy_cb(void *dest, const void *source, size_t len _U_)
+{
+    const osc_seq_uat_t *o = (const osc_seq_uat_t *)source;
+    osc_seq_uat_t       *d = (osc_seq_uat_t *)dest;
+
+    d->pattern = g_strdup(o->pattern);
+    d->arg_index = o->arg_index;
+
+    return dest;
+}
+
+static void
+osc_seq_uat_update_cb(void *r, const char **err)
+{
+    osc_seq_uat_t *rec = (osc_seq_uat_t *)r;
+
+    if( !rec->pattern || (rec->pattern[0] != '/') )
+        *err = "Address pattern must start with '/'";
+}
+
+static void
+osc_seq_uat_free_cb(void *r)
+{
+    osc_seq_uat_t *rec = (osc_seq_uat_t *)r;
+
+    g_free(rec->pattern);
+}
+
+static void
+osc_seq_uat_post_update_cb(void)
+{
+    guint i;
+
+    if(osc_seq_exact)
+        g_hash_table_destroy(osc_seq_exact);
+    if(osc_seq_patterns)
+    {
+        for(i=0; i<osc_seq_patterns->len; i++)
+        {
+            osc_seq_pattern_t *pat = (osc_seq_pattern_t *)g_ptr_array_index(osc_seq_patterns, i);
+            g_pattern_spec_free(pat->spec);
+            g_free(pat);
+        }
+        g_ptr_array_free(osc_seq_patterns, TRUE);
+    }
+
+    osc_seq_exact = g_hash_table_new(g_str_hash, g_str_equal);
+    osc_seq_patterns = g_ptr_array_new();
+
+    for(i=0; i<num_osc_seq_uats; i++)
+    {
+        osc_seq_uat_t *rec = &osc_seq_uats[i];
+
+        if(strpbrk(rec->pattern, "*?"))
+        {
+            osc_seq_pattern_t *pat = g_new0(osc_seq_pattern_t, 1);
+
+            pat->spec = g_pattern_spec_new(rec->pattern);
+            pat->arg_index = rec->arg_index;
+            g_ptr_array_add(osc_seq_patterns, pat);
+        }
+        else if(!g_hash_table_lookup(osc_seq_exact, rec->pattern))
+            g_hash_table_insert(osc_seq_exact, rec->pattern, rec);
+    }
+}
+
+/* get sequence number argument index of path, resolved once per conversation and path */
+static gint
+osc_seq_lookup(osc_path_info_t *path_info, const gchar *path)
+{
+    if(!path_info->seq_resolved)
+    {
+        osc_seq_uat_t *rec;
+        guint          i;
+
+        path_info->seq_resolved = TRUE;
+        path_info->seq_arg = -1;
+
+        rec = osc_seq_exact ? (osc_seq_uat_t *)g_hash_table_lookup(osc_seq_exact, path) : NULL;
+        if(rec)
+            path_info->seq_arg = rec->arg_index;
+        else if(osc_seq_patterns)
+        {
+            for(i=0; i<osc_seq_patterns->len; i++)
+            {
+                osc_seq_pattern_t *pat = (osc_seq_pattern_t *)g_ptr_array_index(osc_seq_patterns, i);
+                if(g_pattern_match_string(pat->spec, path))
+                {
+                    path_info->seq_arg = pat->arg_index;
+                    break;
+                }
+            }
+        }
+    }
+    return path_info->seq_arg;
+}
+
+/* modular difference of sequence numbers, so counters may wrap around */
+static gint64
+osc_seq_diff(gint64 seq, gint64 base, gboolean is_int32)
+{
+    if(is_int32)
+        return (gint32)((guint32)seq - (guint32)base);
+    else
+        return (gint64)((guint64)seq - (guint64)base);
+}
+
+/* remember a gap, dropping the oldest one when the table is full */
+static void
+osc_seq_add_gap(osc_path_info_t *path_info, gint64 start, guint32 count)
+{
+    if(path_info->seq_n_gaps == OSC_SEQ_MAX_GAPS)
+    {
+        memmove(&path_info->seq_gaps[0], &path_info->seq_gaps[1], (OSC_SEQ_MAX_GAPS - 1) * sizeof(osc_seq_gap_t));
+        path_info->seq_n_gaps--;
+    }
+    path_info->seq_gaps[path_info->seq_n_gaps].start = start;
+    path_info->seq_gaps[path_info->seq_n_gaps].count = count;
+    path_info->seq_n_gaps++;
+}
+
+/* take a late sequence number out of the gap it fell into, FALSE if it was not missing */
+static gboolean
+osc_seq_fill_gap(osc_path_info_t *path_info, gint64 seq, gboolean is_int32)
+{
+    osc_seq_gap_t *gap;
+    gint64         d;
+    guint          i;
+
+    for(i=0; i<path_info->seq_n_gaps; i++)
+    {
+        gap = &path_info->seq_gaps[i];
+        d = osc_seq_diff(seq, gap->start, is_int32);
+        if( (d < 0) || (d >= gap->count) )
+            continue;
+
+        if(d == 0)
+        {
+            gap->start = seq + 1;
+            gap->count--;
+        }
+        else if(d == gap->count - 1)
+            gap->count--;
+        else if(path_info->seq_n_gaps < OSC_SEQ_MAX_GAPS)
+        {
+            /* split, the upper part is inserted right after the lower one */
+            memmove(&path_info->seq_gaps[i+2], &path_info->seq_gaps[i+1],
+                    (path_info->seq_n_gaps - i - 1) * sizeof(osc_seq_gap_t));
+            path_info->seq_gaps[i+1].start = seq + 1;
+            path_info->seq_gaps[i+1].count = gap->count - (guint32)d - 1;
+            gap->count = (guint32)d;
+            path_info->seq_n_gaps++;
+        }
+        else
+        {
+            /* no room to split, forget the older lower part */
+            gap->start = seq + 1;
+            gap->count -= (guint32)d + 1;
+        }
+
+        if(gap->count == 0)
+        {
+            memmove(&path_info->seq_gaps[i], &path_info->seq_gaps[i+1],
+                    (path_info->seq_n_gaps - i - 1) * sizeof(osc_seq_gap_t));
+            path_info->seq_n_gaps--;
+        }
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* check sequence number of a message against the expected one */
+static void
+osc_seq_check(osc_path_info_t *path_info, osc_message_info_t *msg_info, gint64 seq, gboolean is_int32)
+{
+    gint64 diff;
+
+    msg_info->has_seq = TRUE;
+    msg_info->seq = seq;
+
+    if(!path_info->has_seq)
+    {
+        path_info->has_seq = TRUE;
+        path_info->seq_next = seq + 1;
+        return;
+    }
+
+    diff = osc_seq_diff(seq, path_info->seq_next, is_int32);
+
+    if(diff >= 0)
+    {
+        msg_info->seq_lost = (diff > G_MAXUINT32) ? G_MAXUINT32 : (guint32)diff;
+        if(msg_info->seq_lost)
+            osc_seq_add_gap(path_info, path_info->seq_next, msg_info->seq_lost);
+        path_info->seq_next = seq + 1;
+    }
+    /* only a late message filling a gap counted before makes up for a loss */
+    else if(osc_seq_fill_gap(path_info, seq, is_int32))
+        msg_info->seq_reordered = TRUE;
+    /* a large backward jump is a restarted sender or reset counter, start over */
+    else if( (global_osc_seq_resync > 0) && (-diff > (gint64)global_osc_seq_resync) )
+    {
+        msg_info->seq_resync = TRUE;
+        path_info->seq_next = seq + 1;
+        path_info->seq_n_gaps = 0;
+    }
+    else
+        msg_info->seq_duplicate = TRUE;
+}
+
+/* decide whether message gets fully dissected in sampling mode */
+static void
+osc_sample_check(osc_path_info_t *path_info, osc_message_info_t *msg_info, packet_info *pinfo)
+{
+    gboolean sample = TRUE;
+    nstime_t delta;
+
+    switch(global_osc_sampling)
+    {
+        case OSC_SAMPLING_COUNT:
+            sample = (path_info->sample_count == 0);
+            path_info->sample_count++;
+            if(path_info->sample_count >= global_osc_sampling_count)
+                path_info->sample_count = 0;
+            break;
+        case OSC_SAMPLING_INTERVAL:
+            if(path_info->has_sample_ts)
+            {
+                nstime_delta(&delta, &pinfo->fd->abs_ts, &path_info->sample_ts);
+                sample = nstime_to_msec(&delta) >= global_osc_sampling_interval;
+            }
+            if(sample)
+            {
+                path_info->has_sample_ts = TRUE;
+                path_info->sample_ts = pinfo->fd->abs_ts;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if(sample)
+    {
+        msg_info->sample_skipped = path_info->sample_skipped;
+        path_info->sample_skipped = 0;
+    }
+    else
+    {
+        msg_info->sampled_out = TRUE;
+        path_info->sample_skipped++;
+    }
+}
+
+/* get state of next message within PDU, *is_new is set during the first pass */
+static osc_message_info_t *
+get_osc_message_info(osc_ctx_t *ctx, gboolean *is_new)
+{
+    osc_pdu_info_t *pdu_info = ctx->pdu_info;
+    guint           msg_index = ctx->msg_index++;
+
+    osc_message_info_t *msg_info;
+
+    if(!pdu_info->messages)
+        pdu_info->messages = wmem_array_new(wmem_file_scope(), sizeof(osc_message_info_t *));
+
+    /* store pointers, as tap records refer to them until the end of the packet */
+    *is_new = (msg_index >= wmem_array_get_count(pdu_info->messages));
+    if(*is_new)
+    {
+        msg_info = wmem_new0(wmem_file_scope(), osc_message_info_t);
+        wmem_array_append_one(pdu_info->messages, msg_info);
+    }
+    else
+        msg_info = *(osc_message_info_t **)wmem_array_index(pdu_info->messages, msg_index);
+
+    return msg_info;
+}
+
+/* compare argument vector with the last one of the same path and remember it */
+static void
+osc_value_check(osc_path_info_t *path_info, osc_message_info_t *msg_info,
+                guint64 hash, gint len, const gdouble *values, guint n_values)
+{
+    guint i;
+
+    msg_info->analysed = TRUE;
+
+    if(path_info->has_last && (path_info->last_hash == hash) && (path_info->last_len == len))
+    {
+        msg_info->unchanged = TRUE;
+    }
+    else if(path_info->has_last && (path_info->last_n_values == n_values) && (n_values > 0))
+    {
+        gdouble sum = 0.0;
+
+        for(i=0; i<n_values; i++)
+        {
+            gdouble delta = values[i] - path_info->last_values[i];
+            sum += (delta < 0.0) ? -delta : delta;
+        }
+
+        /* NaN or infinite arguments (or their difference) yield no delta, x - x is only 0 for finite x */
+        if(sum - sum == 0.0)
+        {
+            msg_info->has_delta = TRUE;
+            msg_info->mean_delta = sum / n_values;
+        }
+    }
+
+    path_info->has_last = TRUE;
+    path_info->last_hash = hash;
+    path_info->last_len = len;
+    path_info->last_n_values = n_values;
+    for(i=0; i<n_values; i++)
+        path_info->last_values[i] = values[i];
+}
+
+/* osc_strsize results besides the size */
+#define OSC_STRSIZE_UNTERMINATED -1 /* no terminator within the message */
+#define OSC_STRSIZE_TOO_LONG     -2 /* no terminator within the scan limit */
+
+/* get size of NUL terminated string including NUL, scanning at most up to end and the configured limit */
+static gint
+osc_strsize(tvbuff_t *tvb, gint offset, gint end)
+{
+    gint max = end - offset;
+    gint nul;
+
+    if(max <= 0)
+        return OSC_STRSIZE_UNTERMINATED;
+
+    if( (global_osc_string_max_len > 0) && ((guint)max > global_osc_string_max_len) )
+    {
+        nul = tvb_find_guint8(tvb, offset, global_osc_string_max_len, '\0');
+        if(nul < 0)
+            return OSC_STRSIZE_TOO_LONG;
+    }
+    else
+    {
+        nul = tvb_find_guint8(tvb, offset, max, '\0');
+        if(nul < 0)
+            return OSC_STRSIZE_UNTERMINATED;
+    }
+
+    return nul - offset + 1;
+}
+
+/* add head of a string argument longer than the scan limit, the rest of the message is left undecoded */
+static void
+osc_add_long_string(packet_info *pinfo, proto_tree *tree, proto_item *message_item, int hf, tvbuff_t *tvb, gint offset, gint end)
+{
+    proto_item *si;
+
+    si = proto_tree_add_item(tree, hf, tvb, offset, global_osc_string_max_len, ENC_ASCII | ENC_NA);
+    proto_item_append_text(si, " (first %u bytes)", global_osc_string_max_len);
+    proto_tree_add_item(tree, hf_osc_message_undecoded_type, tvb, offset + global_osc_string_max_len,
+                        end - offset - global_osc_string_max_len, ENC_NA);
+    expert_add_info(pinfo, si ? si : message_item, &ei_osc_string_limit);
+}
+
+/* check for valid path string */
+static gboolean
+is_valid_path(const char *path)
+{
+    const char *ptr;
+    if(path[0] != '/')
+        return FALSE;
+    for(ptr=path+1; *ptr!='\0'; ptr++)
+        if( (isprint(*ptr) == 0) || (strchr(invalid_path_chars, *ptr) != NULL) )
+            return FALSE;
+    return TRUE;
+}
+
+/* check for valid format string */
+static gboolean
+is_valid_format(const char *format)
+{
+    const char *ptr;
+    guint       depth = 0;
+    guint       max_depth = MIN(global_osc_array_max_depth, OSC_ARRAY_MAX_DEPTH);
+    if(format[0] != ',')
+        return FALSE;
+    for(ptr=format+1; *ptr!='\0'; ptr++)
+    {
+        if(*ptr == OSC_ARRAY_BEGIN)
+        {
+            if(++depth > max_depth)
+                return FALSE;
+        }
+        else if(*ptr == OSC_ARRAY_END)
+        {
+            if(depth-- == 0)
+                return FALSE;
+        }
+        else if(strchr(valid_format_chars, *ptr) == NULL)
+        {
+            /* unknown type tags end the arguments that can be parsed */
+            if(!global_osc_unknown_tags || (isprint(*ptr) == 0) )
+                return FALSE;
+        }
+    }
+    return depth == 0;
+}
+
+static osc_check_t check_osc_element(tvbuff_t *tvb, gint offset, gint len, guint depth);
+
+/* check message structure without dissecting it */
+static osc_check_t
+check_osc_message(tvbuff_t *tvb, gint offset, gint len)
+{
+    gint         end = offset + len;
+    gint         slen;
+    gint         rem;
+    gint32       blen;
+    const gchar *format;
+    const gchar *ptr;
+
+    /* path */
+    if( (slen = osc_strsize(tvb, offset, end)) < 0)
+        return OSC_CHECK_STRING;
+    if(!is_valid_path((const gchar *)tvb_get_ptr(tvb, offset, slen)))
+        return OSC_CHECK_PATH;
+    if( (rem = slen%4) ) slen += 4-rem;
+    offset += slen;
+
+    /* format */
+    if( (slen = osc_strsize(tvb, offset, end)) < 0)
+        return OSC_CHECK_STRING;
+    format = (const gchar *)tvb_get_ptr(tvb, offset, slen);
+    if(!is_valid_format(format))
+        return OSC_CHECK_FORMAT;
+    if( (rem = slen%4) ) slen += 4-rem;
+    offset += slen;
+
+    /* arguments */
+    for(ptr=format+1; *ptr!='\0'; ptr++)
+    {
+        switch(*ptr)
+        {
+            case OSC_INT32:
+            case OSC_FLOAT:
+            case OSC_CHAR:
+            case OSC_RGBA:
+            case OSC_MIDI:
+                offset += 4;
+                break;
+            case OSC_INT64:
+            case OSC_DOUBLE:
+            case OSC_TIMETAG:
+                offset += 8;
+                break;
+            case OSC_STRING:
+            case OSC_SYMBOL:
+                slen = osc_strsize(tvb, offset, end);
+                if(slen == OSC_STRSIZE_TOO_LONG) /* the rest is tolerated, like by the dissection */
+                    return OSC_CHECK_OK;
+                if(slen < 0)
+                    return OSC_CHECK_STRING;
+                if( (rem = slen%4) ) slen += 4-rem;
+                offset += slen;
+                break;
+            case OSC_BLOB:
+                if(end - offset < 4)
+                    return OSC_CHECK_SIZE;
+                blen = tvb_get_ntohl(tvb, offset);
+                if( (blen < 0) || (blen > end - offset - 4) )
+                    return OSC_CHECK_BLOB;
+                if( (rem = blen%4) ) blen += 4-rem;
+                offset += 4 + blen;
+                break;
+            case OSC_TRUE:
+            case OSC_FALSE:
+            case OSC_NIL:
+            case OSC_BANG:
+            case OSC_ARRAY_BEGIN:
+            case OSC_ARRAY_END:
+                /* no argument data */
+                break;
+            default: /* unknown type tag of unknown size, accepted by is_valid_format */
+                return OSC_CHECK_OK;
+        }
+        if(offset > end)
+            return OSC_CHECK_SIZE;
+    }
+
+    return (offset == end) ? OSC_CHECK_OK : OSC_CHECK_SIZE;
+}
+
+/* check bundle structure without dissecting it */
+static osc_check_t
+check_osc_bundle(tvbuff_t *tvb, gint offset, gint len, guint depth)
+{
+    gint        end = offset + len;
+    gint32      size;
+    osc_check_t check;
+
+    if( (depth > OSC_CHECK_MAX_DEPTH) || (len < 16) || (tvb_strneql(tvb, offset, bundle_str, 8) != 0) )
+        return OSC_CHECK_BUNDLE;
+    offset += 16; /* skip bundle_str and timetag */
+
+    while(offset < end)
+    {
+        if(end - offset < 4)
+            return OSC_CHECK_SIZE;
+        size = tvb_get_ntohl(tvb, offset);
+        offset += 4;
+
+        if( (size < 0) || (size > end - offset) )
+            return OSC_CHECK_SIZE;
+        if( (size > 0) && ((check = check_osc_element(tvb, offset, size, depth + 1)) != OSC_CHECK_OK) )
+            return check;
+        offset += size;
+    }
+
+    return (offset == end) ? OSC_CHECK_OK : OSC_CHECK_SIZE;
+}
+
+/* check structure of bundle or message without dissecting it */
+static osc_check_t
+check_osc_element(tvbuff_t *tvb, gint offset, gint len, guint depth)
+{
+    if(len <= 0)
+        return OSC_CHECK_SIZE;
+
+    switch(tvb_get_guint8(tvb, offset))
+    {
+        case '#': /* this is a bundle */
+            return check_osc_bundle(tvb, offset, len, depth);
+        case '/': /* this is a message */
+            return check_osc_message(tvb, offset, len);
+        default: /* neither message nor bundle */
+            return OSC_CHECK_ELEMENT;
+    }
+}
+
+/* Dissect OSC message */
+static int
+dissect_osc_message(tvbuff_t *tvb, osc_ctx_t *ctx, proto_item *ti, proto_tree *osc_tree, gint offset, gint len)
+{
+    proto_item  *message_item;
+    proto_tree  *message_tree;
+    proto_tree  *header_tree;
+    gint         slen;
+    gint         rem;
+    gint         end = offset + len;
+    const gchar *path;
+    gint         path_len;
+    gint         path_offset;
+    gint         padding;
+    const gchar *format;
+    gint         format_offset;
+    gint         format_len;
+    const gchar *ptr;
+    osc_message_info_t *msg_info;
+    gboolean     is_new;
+    gboolean     collect;
+    gboolean     add_ns;
+    gboolean     collect_ns;
+    guint        blob_index = 0;
+    gdouble      values[OSC_VALUE_MAX_ARGS];
+    guint        n_values = 0;
+    osc_path_info_t *path_info = NULL;
+    gint         arg_index = 0;
+    gint         seq_arg = -1;
+    gboolean     has_seq = FALSE;
+    gboolean     seq_is_int32 = FALSE;
+    gint64       seq = 0;
+    proto_tree  *arg_tree;
+    proto_tree  *array_trees[OSC_ARRAY_MAX_DEPTH];
+    proto_item  *array_items[OSC_ARRAY_MAX_DEPTH];
+    gint         array_offsets[OSC_ARRAY_MAX_DEPTH];
+    guint        array_depth = 0;
+
+    /* peek/read path */
+    path_offset = offset;
+    if( (path_len = osc_strsize(tvb, path_offset, end)) < 0)
+        return -1;
+    path = (const gchar *)tvb_get_ptr(tvb, path_offset, path_len);
+    if( (rem = path_len%4) ) path_len += 4-rem;
+    padding = rem ? 4-rem : 0;
+
+    if(!is_valid_path(path))
+        return -1;
+
+    /* peek/read fmt */
+    format_offset = path_offset + path_len;
+    if( (format_len = osc_strsize(tvb, format_offset, end)) < 0)
+        return -1;
+    format = (const gchar *)tvb_get_ptr(tvb, format_offset, format_len);
+    if( (rem = format_len%4) ) format_len += 4-rem;
+    padding += rem ? 4-rem : 0;
+
+    if(!is_valid_format(format))
+        return -1;
+
+    msg_info = get_osc_message_info(ctx, &is_new);
+
+    /* per path analysis runs once, during the first pass */
+    if(is_new && !ctx->pinfo->fd->flags.visited
+            && (global_osc_value_analysis || (num_osc_seq_uats > 0) || (global_osc_sampling != OSC_SAMPLING_OFF)) )
+    {
+        path_info = get_osc_path_info(ctx->conv_info, path);
+        if(num_osc_seq_uats > 0)
+            seq_arg = osc_seq_lookup(path_info, path);
+        if(global_osc_sampling != OSC_SAMPLING_OFF)
+            osc_sample_check(path_info, msg_info, ctx->pinfo);
+    }
+
+    /* the namespace is built once, from valid messages only, during the first pass
+     * or during the retap of a namespace view opened later */
+    add_ns = !msg_info->ns_node && (global_osc_namespace || osc_ns_requested);
+
+    /* value ranges are only taken from messages whose arguments are parsed anyway */
+    collect_ns = add_ns && !msg_info->sampled_out;
+
+    /* only collect numeric values when they are going to be compared */
+    collect = path_info && global_osc_value_analysis;
+
+    col_append_sep_str(ctx->pinfo->cinfo, COL_INFO, ", ", path);
+
+    /* create message */
+    if(msg_info->sampled_out)
+    {
+        /* arguments are only parsed, without tree, when analysis or taps need them */
+        message_item = proto_tree_add_item(osc_tree, hf_osc_message_type, tvb, offset, len, ENC_NA);
+        proto_item_set_text(message_item, "Message: %s (not sampled)", path);
+        if(osc_tree)
+            ctx->elements++;
+        if( !(collect || (seq_arg >= 0) || have_tap_listener(osc_tap)) )
+        {
+            /* arguments are not checked, path and format are */
+            if(add_ns)
+            {
+                msg_info->ns_node = osc_ns_insert(path, ctx->pinfo->fd->num);
+                msg_info->ns_signature = osc_ns_signature(msg_info->ns_node, format, ctx->pinfo->fd->num);
+            }
+            return 0;
+        }
+        message_tree = NULL;
+    }
+    else
+    {
+        /* the label is not built for items that are not displayed */
+        message_item = proto_tree_add_item(osc_tree, hf_osc_message_type, tvb, offset, len, ENC_NA);
+        proto_item_set_text(message_item, "Message: %s %s", path, format);
+        message_tree = proto_item_add_subtree(message_item, ett_osc_message);
+        if(message_tree)
+            ctx->elements++;
+    }
+
+    if(msg_info->sample_skipped)
+    {
+        proto_item *si;
+
+        si = proto_tree_add_uint(message_tree, hf_osc_sampling_skipped_type, tvb, offset, 0, msg_info->sample_skipped);
+        PROTO_ITEM_SET_GENERATED(si);
+    }
+
+    /* append header */
+    ti = proto_tree_add_item(message_tree, hf_osc_message_header_type, tvb, offset, path_len+format_len, ENC_NA);
+    header_tree = proto_item_add_subtree(ti, ett_osc_message_header);
+
+    /* append path */
+    proto_tree_add_item(header_tree, hf_osc_message_path_type, tvb, path_offset, path_len, ENC_ASCII | ENC_NA);
+
+    /* append format */
+    proto_tree_add_item(header_tree, hf_osc_message_format_type, tvb, format_offset, format_len, ENC_ASCII | ENC_NA);
+
+    offset += path_len + format_len;
+
+    /* ::parse argument:: */
+    /* arrays are walked with an explicit stack of their enclosing trees, is_valid_format bounds its depth */
+    arg_tree = message_tree;
+    ptr = format + 1; /* skip ',' */
+    while( (*ptr != '\0') && ((offset < end) || (strchr(empty_format_chars, *ptr) != NULL)) )
+    {
+        switch(*ptr)
+        {
+            case OSC_ARRAY_BEGIN:
+                DISSECTOR_ASSERT(array_depth < OSC_ARRAY_MAX_DEPTH);
+                array_trees[array_depth] = arg_tree;
+                array_offsets[array_depth] = offset;
+                array_items[array_depth] = proto_tree_add_item(arg_tree, hf_osc_message_array_type, tvb, offset, 0, ENC_NA);
+                arg_tree = proto_item_add_subtree(array_items[array_depth], ett_osc_array);
+                array_depth++;
+                ptr++;
+                if(message_tree)
+                    ctx->elements++;
+                continue; /* array markers are no arguments */
+            case OSC_ARRAY_END:
+                DISSECTOR_ASSERT(array_depth > 0);
+                array_depth--;
+                proto_item_set_len(array_items[array_depth], offset - array_offsets[array_depth]);
+                arg_tree = array_trees[array_depth];
+                ptr++;
+                continue;
+
+            case OSC_INT32:
+                if(arg_index == seq_arg)
+                {
+                    seq = (gint32)tvb_get_ntohl(tvb, offset);
+                    seq_is_int32 = TRUE;
+                    has_seq = TRUE;
+                }
+                if( (collect || collect_ns) && (n_values < OSC_VALUE_MAX_ARGS) )
+                    values[n_values++] = (gint32)tvb_get_ntohl(tvb, offset);
+                proto_tree_add_item(arg_tree, hf_osc_message_int32_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                offset += 4;
+                break;
+            case OSC_FLOAT:
+                if( (collect || collect_ns) && (n_values < OSC_VALUE_MAX_ARGS) )
+                    values[n_values++] = tvb_get_ntohieee_float(tvb, offset);
+                proto_tree_add_item(arg_tree, hf_osc_message_float_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                offset += 4;
+                break;
+            case OSC_STRING:
+                slen = osc_strsize(tvb, offset, end);
+                if(slen == OSC_STRSIZE_TOO_LONG)
+                {
+                    osc_add_long_string(ctx->pinfo, arg_tree, message_item, hf_osc_message_string_type, tvb, offset, end);
+                    offset = end;
+                    ptr += strlen(ptr);
+                    continue;
+                }
+                if(slen < 0)
+                {
+                    expert_add_info(ctx->pinfo, message_item, &ei_osc_string_size);
+                    return -1;
+                }
+                if( (rem = slen%4) ) slen += 4-rem;
+                padding += rem ? 4-rem : 0;
+                proto_tree_add_item(arg_tree, hf_osc_message_string_type, tvb, offset, slen, ENC_ASCII | ENC_NA);
+                offset += slen;
+                break;
+            case OSC_BLOB:
+            {
+                proto_item *bi;
+                proto_tree *blob_tree;
+
+                gint32 blen = tvb_get_ntohl(tvb, offset);
+
+                /* the size is taken from the packet, it must fit into the remaining message */
+                if( (blen < 0) || (blen > end - offset - 4) )
+                {
+                    bi = proto_tree_add_item(arg_tree, hf_osc_message_blob_size_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                    expert_add_info(ctx->pinfo, bi, &ei_osc_blob_size);
+                    return -1;
+                }
+
+                slen = blen;
+                if( (rem = slen%4) ) slen += 4-rem;
+                padding += rem ? 4-rem : 0;
+
+                bi = proto_tree_add_int(arg_tree, hf_osc_message_blob_type, tvb, offset, 4+slen, blen);
+                blob_tree = proto_item_add_subtree(bi, ett_osc_blob);
+
+                proto_tree_add_item(blob_tree, hf_osc_message_blob_size_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                offset += 4;
+
+                /* check for zero length blob */
+                if(blen == 0)
+                    break;
+
+                if( (global_osc_blob_max_bytes > 0) && ((guint)blen > global_osc_blob_max_bytes) )
+                {
+                    proto_item *di;
+
+                    /* only show the head of large blobs, summarized by a hash of the whole */
+                    di = proto_tree_add_item(blob_tree, hf_osc_message_blob_data_type, tvb, offset, global_osc_blob_max_bytes, ENC_NA);
+                    proto_item_append_text(di, " (first %u of %i bytes)", global_osc_blob_max_bytes, blen);
+
+                    /* the hash is computed once, when the message is first dissected */
+                    if(is_new)
+                    {
+                        guint64 hash = osc_hash(tvb, offset, blen);
+
+                        if(!msg_info->blob_hashes)
+                            msg_info->blob_hashes = wmem_array_new(wmem_file_scope(), sizeof(guint64));
+                        wmem_array_append_one(msg_info->blob_hashes, hash);
+                    }
+                    if(blob_tree && msg_info->blob_hashes && (blob_index < wmem_array_get_count(msg_info->blob_hashes)) )
+                    {
+                        di = proto_tree_add_uint64(blob_tree, hf_osc_message_blob_hash_type, tvb, offset, blen,
+                                                   *(guint64 *)wmem_array_index(msg_info->blob_hashes, blob_index));
+                        PROTO_ITEM_SET_GENERATED(di);
+                    }
+                    blob_index++;
+                }
+                else
+                    proto_tree_add_item(blob_tree, hf_osc_message_blob_data_type, tvb, offset, slen, ENC_NA);
+                offset += slen;
+                break;
+            }
+
+            case OSC_TRUE:
+                proto_tree_add_item(arg_tree, hf_osc_message_true_type, tvb, offset, 0, ENC_NA);
+                break;
+            case OSC_FALSE:
+                proto_tree_add_item(arg_tree, hf_osc_message_false_type, tvb, offset, 0, ENC_NA);
+                break;
+            case OSC_NIL:
+                proto_tree_add_item(arg_tree, hf_osc_message_nil_type, tvb, offset, 0, ENC_NA);
+                break;
+            case OSC_BANG:
+                proto_tree_add_item(arg_tree, hf_osc_message_bang_type, tvb, offset, 0, ENC_NA);
+                break;
+
+            case OSC_INT64:
+                if(arg_index == seq_arg)
+                {
+                    seq = (gint64)tvb_get_ntoh64(tvb, offset);
+                    has_seq = TRUE;
+                }
+                if( (collect || collect_ns) && (n_values < OSC_VALUE_MAX_ARGS) )
+                    values[n_values++] = (gdouble)(gint64)tvb_get_ntoh64(tvb, offset);
+                proto_tree_add_item(arg_tree, hf_osc_message_int64_type, tvb, offset, 8, ENC_BIG_ENDIAN);
+                offset += 8;
+                break;
+            case OSC_DOUBLE:
+                if( (collect || collect_ns) && (n_values < OSC_VALUE_MAX_ARGS) )
+                    values[n_values++] = tvb_get_ntohieee_double(tvb, offset);
+                proto_tree_add_item(arg_tree, hf_osc_message_double_type, tvb, offset, 8, ENC_BIG_ENDIAN);
+                offset += 8;
+                break;
+            case OSC_TIMETAG:
+            {
+                guint32  sec  = tvb_get_ntohl(tvb, offset);
+                guint32  frac = tvb_get_ntohl(tvb, offset+4);
+                nstime_t ns;
+                if( (sec == 0) && (frac == 1) )
+                    proto_tree_add_time_format_value(arg_tree, hf_osc_message_timetag_type, tvb, offset, 8, &ns, immediate_fmt, immediate_str);
+                else
+                    proto_tree_add_item(arg_tree, hf_osc_message_timetag_type, tvb, offset, 8, ENC_TIME_NTP | ENC_BIG_ENDIAN);
+                offset += 8;
+            }
+                break;
+
+            case OSC_SYMBOL:
+                slen = osc_strsize(tvb, offset, end);
+                if(slen == OSC_STRSIZE_TOO_LONG)
+                {
+                    osc_add_long_string(ctx->pinfo, arg_tree, message_item, hf_osc_message_symbol_type, tvb, offset, end);
+                    offset = end;
+                    ptr += strlen(ptr);
+                    continue;
+                }
+                if(slen < 0)
+                {
+                    expert_add_info(ctx->pinfo, message_item, &ei_osc_string_size);
+                    return -1;
+                }
+                if( (rem = slen%4) ) slen += 4-rem;
+                padding += rem ? 4-rem : 0;
+                proto_tree_add_item(arg_tree, hf_osc_message_symbol_type, tvb, offset, slen, ENC_ASCII | ENC_NA);
+                offset += slen;
+                break;
+            case OSC_CHAR:
+                padding += 3;
+                offset += 3;
+                proto_tree_add_item(arg_tree, hf_osc_message_char_type, tvb, offset, 1, ENC_ASCII | ENC_NA);
+                offset += 1;
+                break;
+            case OSC_RGBA:
+            {
+                proto_item *ri;
+                proto_tree *rgba_tree;
+
+                ri = proto_tree_add_item(arg_tree, hf_osc_message_rgba_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                rgba_tree = proto_item_add_subtree(ri, ett_osc_rgba);
+
+                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_red_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_green_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_blue_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+                proto_tree_add_item(rgba_tree, hf_osc_message_rgba_alpha_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+                break;
+            }
+            case OSC_MIDI:
+            {
+                proto_item  *mi;
+                proto_tree  *midi_tree;
+                guint8       status;
+
+                status = tvb_get_guint8(tvb, offset+1);
+
+                mi = proto_tree_add_item(arg_tree, hf_osc_message_midi_type, tvb, offset, 4, ENC_BIG_ENDIAN);
+                midi_tree = proto_item_add_subtree(mi, ett_osc_midi);
+
+                proto_tree_add_item(midi_tree, hf_osc_message_midi_channel_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+
+                proto_tree_add_item(midi_tree, hf_osc_message_midi_status_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                offset += 1;
+
+                if(status == MIDI_STATUS_CONTROLLER)
+                {
+                    proto_tree_add_item(midi_tree, hf_osc_message_midi_controller_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                    offset += 1;
+
+                    proto_tree_add_item(midi_tree, hf_osc_message_midi_value_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                    offset += 1;
+                }
+                else
+                {
+                    proto_tree_add_item(midi_tree, hf_osc_message_midi_data1_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                    offset += 1;
+
+                    proto_tree_add_item(midi_tree, hf_osc_message_midi_data2_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+                    offset += 1;
+                }
+
+                break;
+            }
+
+            default:
+            {
+                proto_item *ui;
+
+                /* only accepted by is_valid_format when unknown type tags are tolerated,
+                 * the size is unknown, so the remaining arguments are left undecoded */
+                DISSECTOR_ASSERT(global_osc_unknown_tags);
+                ui = proto_tree_add_item(arg_tree, hf_osc_message_undecoded_type, tvb, offset, end - offset, ENC_NA);
+                expert_add_info_format(ctx->pinfo, ui ? ui : message_item, &ei_osc_unknown_tag,
+                                       "Unknown type tag '%c', remaining arguments not dissected", *ptr);
+                offset = end;
+                ptr += strlen(ptr);
+                continue;
+            }
+        }
+        ptr++;
+        arg_index++;
+        if(message_tree)
+            ctx->elements++;
+    }
+
+    /* arrays left open by undecoded arguments extend to the end of the message */
+    for(; array_depth > 0; array_depth--)
+        proto_item_set_len(array_items[array_depth-1], offset - array_offsets[array_depth-1]);
+
+    if(offset != end)
+        return -1;
+
+    if(has_seq)
+        osc_seq_check(path_info, msg_info, seq, seq_is_int32);
+
+    /* format and arguments are compared in one go */
+    if(collect)
+        osc_value_check(path_info, msg_info,
+                        osc_hash(tvb, format_offset, end - format_offset), end - format_offset,
+                        values, n_values);
+
+    if(add_ns)
+    {
+        msg_info->ns_node = osc_ns_insert(path, ctx->pinfo->fd->num);
+        msg_info->ns_signature = osc_ns_signature(msg_info->ns_node, format, ctx->pinfo->fd->num);
+        if(collect_ns)
+            osc_ns_ranges(msg_info->ns_signature, values, n_values);
+    }
+
+    if(msg_info->ns_node)
+    {
+        proto_item *ni;
+
+        ni = proto_tree_add_uint(message_tree, hf_osc_ns_first_frame_type, tvb, offset, 0, msg_info->ns_node->first_frame);
+        PROTO_ITEM_SET_GENERATED(ni);
+        ni = proto_tree_add_uint(message_tree, hf_osc_ns_last_frame_type, tvb, offset, 0, msg_info->ns_node->last_frame);
+        PROTO_ITEM_SET_GENERATED(ni);
+    }
+
+    if(msg_info->analysed)
+    {
+        proto_item *ui;
+
+        ui = proto_tree_add_boolean(message_tree, hf_osc_unchanged_type, tvb, offset, 0, msg_info->unchanged);
+        PROTO_ITEM_SET_GENERATED(ui);
+    }
+
+    if(msg_info->has_seq)
+    {
+        proto_item *si;
+
+        si = proto_tree_add_int64(message_tree, hf_osc_seq_type, tvb, offset, 0, msg_info->seq);
+        PROTO_ITEM_SET_GENERATED(si);
+
+        if(msg_info->seq_lost)
+        {
+            si = proto_tree_add_uint(message_tree, hf_osc_seq_lost_type, tvb, offset, 0, msg_info->seq_lost);
+            PROTO_ITEM_SET_GENERATED(si);
+            expert_add_info_format(ctx->pinfo, si, &ei_osc_seq_gap, "Sequence gap: %u messages missing", msg_info->seq_lost);
+        }
+        if(msg_info->seq_reordered)
+        {
+            si = proto_tree_add_boolean(message_tree, hf_osc_seq_reordered_type, tvb, offset, 0, TRUE);
+            PROTO_ITEM_SET_GENERATED(si);
+            expert_add_info(ctx->pinfo, si, &ei_osc_seq_reordered);
+        }
+        if(msg_info->seq_duplicate)
+        {
+            si = proto_tree_add_boolean(message_tree, hf_osc_seq_duplicate_type, tvb, offset, 0, TRUE);
+            PROTO_ITEM_SET_GENERATED(si);
+            expert_add_info(ctx->pinfo, si, &ei_osc_seq_duplicate);
+        }
+        if(msg_info->seq_resync)
+        {
+            si = proto_tree_add_boolean(message_tree, hf_osc_seq_resync_type, tvb, offset, 0, TRUE);
+            PROTO_ITEM_SET_GENERATED(si);
+            expert_add_info(ctx->pinfo, si, &ei_osc_seq_resync);
+        }
+    }
+
+    if(have_tap_listener(osc_tap))
+    {
+        osc_tap_info_t *tap_info = wmem_new0(wmem_packet_scope(), osc_tap_info_t);
+
+        tap_info->type = OSC_TAP_MESSAGE;
+        tap_info->conv = ctx->conv_info;
+        tap_info->len = len;
+        tap_info->bundleable = ctx->pdu_info->bundleable;
+        tap_info->path = path;
+        tap_info->msg_info = msg_info;
+        tap_info->bundled = ctx->depth > 0;
+        tap_info->address_bytes = (guint32)strlen(path) + 1;
+        tap_info->typetag_bytes = (guint32)strlen(format) + 1;
+        tap_info->padding_bytes = padding;
+        tap_info->argument_bytes = len - tap_info->address_bytes - tap_info->typetag_bytes - padding;
+        tap_queue_packet(osc_tap, ctx->pinfo, tap_info);
+    }
+
+    return 0;
+}
+
+/* Dissect OSC bundle */
+static int
+dissect_osc_bundle(tvbuff_t *tvb, osc_ctx_t *ctx, proto_item *ti, proto_tree *osc_tree, gint offset, gint len)
+{
+    proto_tree  *bundle_tree;
+    gint         end = offset + len;
+    guint32      sec;
+    guint32      frac;
+    nstime_t     ns;
+
+    /* check for valid #bundle */
+    if(tvb_strneql(tvb, offset, bundle_str, 8) != 0)
+        return -1;
+
+    /* create bundle */
+    ti = proto_tree_add_item(osc_tree, hf_osc_bundle_type, tvb, offset, len, ENC_NA);
+
+    bundle_tree = proto_item_add_subtree(ti, ett_osc_bundle);
+
+    offset += 8; /* skip bundle_str */
+
+    ctx->bundle_bytes += 16; /* bundle_str and timetag */
+    if(bundle_tree)
+        ctx->elements++;
+
+    /* read timetag */
+    sec  = tvb_get_ntohl(tvb, offset);
+    frac = tvb_get_ntohl(tvb, offset+4);
+    if( (sec == 0) && (frac == 1) )
+        proto_tree_add_time_format_value(bundle_tree, hf_osc_bundle_timetag_type, tvb, offset, 8, &ns, immediate_fmt, immediate_str);
+    else
+        proto_tree_add_item(bundle_tree, hf_osc_bundle_timetag_type, tvb, offset, 8, ENC_TIME_NTP | ENC_BIG_ENDIAN);
+    offset += 8;
+
+    /* ::read size, read block:: */
+    while(offset < end)
+    {
+        /* peek bundle element size */
+        gint32 size = tvb_get_ntohl(tvb, offset);
+
+        /* read bundle element size */
+        proto_tree_add_int_format_value(bundle_tree, hf_osc_bundle_element_size_type, tvb, offset, 4, size, "%i bytes", size);
+        offset += 4;
+        ctx->bundle_bytes += 4;
+
+        /* check for zero size bundle element */
+        if(size == 0)
+            continue;
+
+        /* peek first bundle element char */
+        ctx->depth++;
+        if(ctx->depth > ctx->max_depth)
+            ctx->max_depth = ctx->depth;
+        switch(tvb_get_guint8(tvb, offset))
+        {
+            case '#': /* this is a bundle */
+                if(dissect_osc_bundle(tvb, ctx, ti, bundle_tree, offset, size))
+                    return -1;
+                else
+                    break;
+            case '/': /* this is a message */
+                if(dissect_osc_message(tvb, ctx, ti, bundle_tree, offset, size))
+                    return -1;
+                else
+                    break;
+            default:
+                return -1; /* neither message nor bundle */
+        }
+        ctx->depth--;
+
+        /* check for integer overflow */
+        if(size > G_MAXINT - offset)
+            return -1;
+        else
+            offset += size;
+    }
+
+    if(offset != end)
+        return -1;
+    else
+        return 0;
+}
+
+/* Dissect OSC PDU */
+static gboolean
+dissect_osc_pdu_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data _U_,
+                       osc_conv_info_t *conv_info, gint offset, gint len)
+{
+    proto_item     *ti;
+    proto_tree     *osc_tree;
+    osc_pdu_info_t *pdu_info;
+    osc_ctx_t       ctx;
+    gint            status = -1;
+
+    col_set_str(pinfo->cinfo, COL_PROTOCOL, "OSC");
+
+    /* later PDUs of the same frame append their paths to those of the earlier ones */
+    if(!p_get_proto_data(pinfo->pool, pinfo, proto_osc, OSC_PDU_COUNTER_KEY))
+        col_clear(pinfo->cinfo, COL_INFO);
+
+    /* analysis needs to run on every pass, not only when details are asked for */
+    pdu_info = get_osc_pdu_info(tvb, pinfo, conv_info, offset, len);
+
+    ctx.pinfo = pinfo;
+    ctx.conv_info = conv_info;
+    ctx.pdu_info = pdu_info;
+    ctx.msg_index = 0;
+    ctx.depth = 0;
+    ctx.max_depth = 0;
+    ctx.bundle_bytes = 0;
+    ctx.elements = 0;
+
+    /* create OSC packet */
+    ti = proto_tree_add_item(tree, proto_osc, tvb, 0, -1, ENC_NA);
+    osc_tree = proto_item_add_subtree(ti, ett_osc_packet);
+
+    if(pdu_info->duplicate_of)
+    {
+        proto_item *di;
+
+        di = proto_tree_add_uint(osc_tree, hf_osc_duplicate_of_type, tvb, offset, len, pdu_info->duplicate_of);
+        PROTO_ITEM_SET_GENERATED(di);
+        expert_add_info_format(pinfo, di, &ei_osc_duplicate, "Duplicate of frame %u", pdu_info->duplicate_of);
+    }
+
+    /* peek first bundle element char */
+    switch(tvb_get_guint8(tvb, offset))
+    {
+        case '#': /* this is a bundle */
+            status = dissect_osc_bundle(tvb, &ctx, ti, osc_tree, offset, len);
+            break;
+        case '/': /* this is a message */
+            status = dissect_osc_message(tvb, &ctx, ti, osc_tree, offset, len);
+            break;
+        default: /* neither message nor bundle */
+            break;
+    }
+
+    /* marks the paths of this PDU only, further PDUs of the frame follow */
+    if(pdu_info->duplicate_of)
+        col_append_str(pinfo->cinfo, COL_INFO, " [Duplicate]");
+
+    /* queued after the message taps, so bundle overhead is complete */
+    if(have_tap_listener(osc_tap))
+    {
+        osc_tap_info_t *tap_info = wmem_new0(wmem_packet_scope(), osc_tap_info_t);
+
+        tap_info->type = OSC_TAP_PDU;
+        tap_info->conv = ctx.conv_info;
+        tap_info->len = len;
+        tap_info->bundleable = pdu_info->bundleable;
+        tap_info->duplicate_of = pdu_info->duplicate_of;
+        tap_info->bundle_bytes = ctx.bundle_bytes;
+        tap_info->elements = ctx.elements;
+        tap_info->max_depth = ctx.max_depth;
+        tap_queue_packet(osc_tap, pinfo, tap_info);
+    }
+
+    return status == 0;
+}
+
+/* queue timing of an entry point call, started at start, to the tap */
+static void
+osc_perf_queue(packet_info *pinfo, osc_perf_entry_t entry, gint64 start, osc_check_t check)
+{
+    osc_tap_info_t *tap_info;
+
+    if(!have_tap_listener(osc_tap))
+        return;
+
+    tap_info = wmem_new0(wmem_packet_scope(), osc_tap_info_t);
+    tap_info->type = OSC_TAP_PERF;
+    tap_info->perf_entry = entry;
+    tap_info->perf_usec = g_get_monotonic_time() - start;
+    tap_info->perf_check = check;
+    tap_queue_packet(osc_tap, pinfo, tap_info);
+}
+
+/* hand OSC packet to the export PDU tap, so it can be saved as standalone packet */
+static void
+export_osc_pdu(tvbuff_t *tvb, packet_info *pinfo)
+{
+    exp_pdu_data_t *exp_pdu_data;
+
+    exp_pdu_data = load_export_pdu_tags(pinfo, "osc", -1,
+                                        EXP_PDU_TAG_IP_SRC_BIT | EXP_PDU_TAG_IP_DST_BIT |
+                                        EXP_PDU_TAG_SRC_PORT_BIT | EXP_PDU_TAG_DST_PORT_BIT |
+                                        EXP_PDU_TAG_ORIG_FNO_BIT);
+
+    exp_pdu_data->tvb_captured_length = tvb_captured_length(tvb);
+    exp_pdu_data->tvb_reported_length = tvb_reported_length(tvb);
+    exp_pdu_data->pdu_tvb = tvb;
+
+    tap_queue_packet(exported_pdu_tap, pinfo, exp_pdu_data);
+}
+
+/* OSC TCP */
+
+static guint
+get_osc_pdu_len(packet_info *pinfo _U_, tvbuff_t *tvb, int offset)
+{
+    return tvb_get_ntohl(tvb, offset) + 4;
+}
+
+static int
+dissect_osc_tcp_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+    gint pdu_len;
+
+    pdu_len = tvb_get_ntohl(tvb, 0);
+
+    /* export without the TCP framing, so it can be read like an OSC UDP packet */
+    if(have_tap_listener(exported_pdu_tap))
+        export_osc_pdu(tvb_new_subset(tvb, 4, pdu_len, pdu_len), pinfo);
+
+    dissect_osc_pdu_common(tvb, pinfo, tree, data, get_osc_conv_info(pinfo), 4, pdu_len);
+    return pdu_len;
+}
+
+static int
+dissect_osc_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+    gint64 start = global_osc_perf ? g_get_monotonic_time() : 0;
+
+    tcp_dissect_pdus(tvb, pinfo, tree, TRUE, 4, get_osc_pdu_len,
+                     dissect_osc_tcp_pdu, data);
+
+    if(global_osc_perf)
+        osc_perf_queue(pinfo, OSC_PERF_TCP, start, OSC_CHECK_OK);
+
+    return tvb_reported_length(tvb);
+}
+
+/* Heuristics */
+
+/* check structure of the whole packet, without propagating exceptions */
+static osc_check_t
+osc_heur_check(tvbuff_t *tvb)
+{
+    osc_check_t check;
+
+    TRY {
+        check = check_osc_element(tvb, 0, tvb_reported_length(tvb), 0);
+    }
+    CATCH_ALL {
+        check = OSC_CHECK_EXCEPTION;
+    }
+    ENDTRY;
+
+    return check;
+}
+
+/* gain confidence over multiple packets, TRUE when the conversation should be bound */
+static gboolean
+osc_heur_confirm(osc_conv_info_t *conv_info)
+{
+    conv_info->heur_score++;
+    if(conv_info->heur_score < global_osc_heur_threshold)
+        return FALSE;
+
+    conv_info->heur_failures = 0;
+    return TRUE;
+}
+
+/* account structure of a PDU of a bound conversation, TRUE when it should be released */
+static gboolean
+osc_heur_release(osc_conv_info_t *conv_info, gboolean valid)
+{
+    if(valid)
+    {
+        if(conv_info->heur_failures > 0)
+            conv_info->heur_failures--;
+        return FALSE;
+    }
+
+    if( (global_osc_heur_max_failures == 0) || (++conv_info->heur_failures < global_osc_heur_max_failures) )
+        return FALSE;
+
+    conv_info->heur_score = 0;
+    conv_info->heur_failures = 0;
+    return TRUE;
+}
+
+/* check whether frame was dissected through the conversation binding during the first pass */
+static gboolean
+osc_heur_in_binding(osc_conv_info_t *conv_info, guint32 frame)
+{
+    if( (conv_info->heur_bound_frame == 0) || (frame < conv_info->heur_bound_frame) )
+        return FALSE;
+
+    return conv_info->heur_bound || (frame <= conv_info->heur_release_frame);
+}
+
+/* OSC UDP */
+
+static int
+dissect_osc_udp_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data, osc_conv_info_t *conv_info)
+{
+    gint             pdu_len;
+    gboolean         valid;
+    gint64           start = global_osc_perf ? g_get_monotonic_time() : 0;
+
+    pdu_len = tvb_reported_length(tvb);
+
+    if(have_tap_listener(exported_pdu_tap))
+        export_osc_pdu(tvb, pinfo);
+
+    valid = dissect_osc_pdu_common(tvb, pinfo, tree, data, conv_info, 0, pdu_len);
+
+    /* release conversations bound by the heuristic once structural failures pile up */
+    if(conv_info->heur_bound && !pinfo->fd->flags.visited && osc_heur_release(conv_info, valid))
+    {
+        conversation_set_dissector(find_or_create_conversation(pinfo), NULL);
+        conv_info->heur_bound = FALSE;
+        conv_info->heur_release_frame = pinfo->fd->num;
+    }
+
+    if(global_osc_perf)
+        osc_perf_queue(pinfo, OSC_PERF_UDP, start, OSC_CHECK_OK);
+
+    return pdu_len;
+}
+
+static int
+dissect_osc_udp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+    osc_conv_info_t *conv_info = get_osc_conv_info(pinfo);
+
+    /* the conversation dissector is not frame ranged, on later passes it also gets the frames
+     * before the binding or after its release, which have to pass the check as on the first pass */
+    if( pinfo->fd->flags.visited && !osc_heur_in_binding(conv_info, pinfo->fd->num)
+            && (osc_heur_check(tvb) != OSC_CHECK_OK) )
+        return 0;
+
+    return dissect_osc_udp_pdu(tvb, pinfo, tree, data, conv_info);
+}
+
+/* UDP Heuristic */
+static gboolean
+dissect_osc_heur_udp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+    conversation_t  *conversation;
+    osc_conv_info_t *conv_info;
+    osc_check_t      check;
+    gint64           start;
+
+    /* frames of a binding released later reach the heuristic again, they stay OSC as on the first pass */
+    if( pinfo->fd->flags.visited && (conv_info = find_osc_conv_info(pinfo))
+            && osc_heur_in_binding(conv_info, pinfo->fd->num) )
+    {
+        dissect_osc_udp_pdu(tvb, pinfo, tree, data, conv_info);
+        return TRUE;
+    }
+
+    start = global_osc_perf ? g_get_monotonic_time() : 0;
+
+    /* Check for valid structure of the whole packet */
+    check = osc_heur_check(tvb);
+
+    /* only the check is timed, the dissection is accounted to dissect_osc_udp */
+    if(global_osc_perf)
+        osc_perf_queue(pinfo, OSC_PERF_HEUR_UDP, start, check);
+
+    if(check != OSC_CHECK_OK)
+    {
+        /* a failure resets the confidence of a conversation not yet bound */
+        if( !pinfo->fd->flags.visited && (conv_info = find_osc_conv_info(pinfo)) )
+            conv_info->heur_score = 0;
+        return FALSE;
+    }
+
+    /* if we get here, then it's an Open Sound Control packet (bundle or message) */
+
+    conv_info = get_osc_conv_info(pinfo);
+    if(!pinfo->fd->flags.visited && !conv_info->heur_bound && osc_heur_confirm(conv_info))
+    {
+        /* specify that dissect_osc is to be called directly from now on for packets for this connection */
+        conversation = find_or_create_conversation(pinfo);
+        conversation_set_dissector(conversation, osc_udp_handle);
+        conv_info->heur_bound = TRUE;
+        conv_info->heur_bound_frame = pinfo->fd->num;
+        conv_info->heur_release_frame = 0;
+    }
+
+    /* do the dissection, the check has been done already */
+    dissect_osc_udp_pdu(tvb, pinfo, tree, data, conv_info);
+
+    return TRUE; /* OSC heuristics was matched */
+}
+
+/* OSC WebSocket */
+
+static int
+dissect_osc_ws(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data, osc_conv_info_t *conv_info)
+{
+    gint     pdu_len;
+    gboolean valid;
+    gint64   start = global_osc_perf ? g_get_monotonic_time() : 0;
+
+    /* the payload arrives unmasked and is dissected in place */
+    pdu_len = tvb_reported_length(tvb);
+
+    if(have_tap_listener(exported_pdu_tap))
+        export_osc_pdu(tvb, pinfo);
+
+    valid = dissect_osc_pdu_common(tvb, pinfo, tree, data, conv_info, 0, pdu_len);
+
+    if(conv_info->ws_bound && !pinfo->fd->flags.visited && osc_heur_release(conv_info, valid))
+        conv_info->ws_bound = FALSE;
+
+    if(global_osc_perf)
+        osc_perf_queue(pinfo, OSC_PERF_WS, start, OSC_CHECK_OK);
+
+    return pdu_len;
+}
+
+/* WebSocket Heuristic */
+static gboolean
+dissect_osc_heur_ws(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+    osc_conv_info_t *conv_info;
+    osc_check_t      check;
+    gint64           start;
+
+    /* the WebSocket conversation stays with its dissector, OSC remembers the binding itself */
+    conv_info = find_osc_conv_info(pinfo);
+    if( (conv_info && conv_info->ws_bound && (pinfo->fd->num >= conv_info->ws_bound_frame))
+            || ( (global_osc_ws_port != 0)
+                && ((pinfo->srcport == global_osc_ws_port) || (pinfo->destport == global_osc_ws_port)) ) )
+    {
+        if(!conv_info)
+            conv_info = get_osc_conv_info(pinfo);
+        dissect_osc_ws(tvb, pinfo, tree, data, conv_info);
+        return TRUE;
+    }
+
+    start = global_osc_perf ? g_get_monotonic_time() : 0;
+
+    /* Check for valid structure of the whole payload */
+    check = osc_heur_check(tvb);
+
+    /* only the check is timed, the dissection is accounted to dissect_osc_ws */
+    if(global_osc_perf)
+        osc_perf_queue(pinfo, OSC_PERF_HEUR_WS, start, check);
+
+    if(check != OSC_CHECK_OK)
+    {
+        /* a failure resets the confidence of a conversation not yet bound */
+        if(conv_info && !pinfo->fd->flags.visited)
+            conv_info->heur_score = 0;
+        return FALSE;
+    }
+
+    /* if we get here, then it's an Open Sound Control payload (bundle or message) */
+
+    if(!conv_info)
+        conv_info = get_osc_conv_info(pinfo);
+    if(!pinfo->fd->flags.visited && !conv_info->ws_bound && osc_heur_confirm(conv_info))
+    {
+        conv_info->ws_bound = TRUE;
+        conv_info->ws_bound_frame = pinfo->fd->num;
+    }
+
+    /* do the dissection */
+    dissect_osc_ws(tvb, pinfo, tree, data, conv_info);
+
+    return TRUE; /* OSC heuristics was matched */
+}
+
+/* Statistics */
+
+static const gchar *st_str_dup = "OSC/Duplicates";
+static const gchar *st_str_dup_packets = "OSC PDUs";
+static int          st_node_dup_packets = -1;
+
+static void
+osc_dup_stats_tree_init(stats_tree *st)
+{
+    st_node_dup_packets = stats_tree_create_node(st, st_str_dup_packets, 0, TRUE);
+}
 
-                channel = tvb_get_guint8(tvb, offset);
-                status  = tvb_get_guint8(tvb, offset+1);
-                data1   = tvb_get_guint8(tvb, offset+2);
-                data2   = tvb_get_guint8(tvb, offset+3);
+static int
+osc_dup_stats_tree_packet(stats_tree *st, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
+{
+    const osc_tap_info_t *tap_info = (const osc_tap_info_t *)p;
+    int                   conv_node;
 
-                status_str = val_to_str_ext_const(status, &MIDI_status_ext, "Unknown");
+    if(tap_info->type != OSC_TAP_PDU)
+        return 0;
 
-                if(status == MIDI_STATUS_CONTROLLER) /* MIDI Controller */
-                {
-                    const gchar *control_str;
-                    control_str = val_to_str_ext_const(data1, &MIDI_control_ext, "Unknown");
-
-                    mi = proto_tree_add_none_format(message_tree, hf_osc_message_midi_type, tvb, offset, 4,
-                            "MIDI: Channel %2i, %s (0x%02x), %s (0x%02x), 0x%02x",
-                            channel,
-                            status_str, status,
-                            control_str, data1,
-                            data2);
-                }
-                else
-                {
-                    mi = proto_tree_add_none_format(message_tree, hf_osc_message_midi_type, tvb, offset, 4,
-                            "MIDI: Channel %2i, %s (0x%02x), 0x%02x, 0x%02x",
-                            channel,
-                            status_str, status,
-                            data1, data2);
-                }
-                midi_tree = proto_item_add_subtree(mi, ett_osc_midi);
+    tick_stat_node(st, st_str_dup_packets, 0, TRUE);
+    conv_node = tick_stat_node(st, tap_info->conv->label, st_node_dup_packets, TRUE);
+    tick_stat_node(st, tap_info->duplicate_of ? "Duplicate" : "Unique", conv_node, FALSE);
 
-                proto_tree_add_item(midi_tree, hf_osc_message_midi_channel_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
+    return 1;
+}
 
-                proto_tree_add_item(midi_tree, hf_osc_message_midi_status_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                offset += 1;
+static const gchar *st_str_value = "OSC/Value Changes";
+static const gchar *st_str_value_messages = "OSC Messages";
+static const gchar *st_str_value_delta = "Mean delta (1/1000)";
+static int          st_node_value_messages = -1;
 
-                if(status == MIDI_STATUS_CONTROLLER)
-                {
-                    proto_tree_add_item(midi_tree, hf_osc_message_midi_controller_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                    offset += 1;
+static void
+osc_value_stats_tree_init(stats_tree *st)
+{
+    st_node_value_messages = stats_tree_create_node(st, st_str_value_messages, 0, TRUE);
+}
 
-                    proto_tree_add_item(midi_tree, hf_osc_message_midi_value_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                    offset += 1;
-                }
-                else
-                {
-                    proto_tree_add_item(midi_tree, hf_osc_message_midi_data1_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                    offset += 1;
+static int
+osc_value_stats_tree_packet(stats_tree *st, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
+{
+    const osc_tap_info_t *tap_info = (const osc_tap_info_t *)p;
+    int                   conv_node;
+    int                   path_node;
 
-                    proto_tree_add_item(midi_tree, hf_osc_message_midi_data2_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-                    offset += 1;
-                }
+    if( (tap_info->type != OSC_TAP_MESSAGE) || !tap_info->msg_info->analysed )
+        return 0;
 
-                break;
-            }
+    tick_stat_node(st, st_str_value_messages, 0, TRUE);
+    conv_node = tick_stat_node(st, tap_info->conv->label, st_node_value_messages, TRUE);
+    path_node = tick_stat_node(st, tap_info->path, conv_node, TRUE);
+    tick_stat_node(st, tap_info->msg_info->unchanged ? "Unchanged" : "Changed", path_node, FALSE);
+    if(tap_info->msg_info->has_delta)
+    {
+        /* mean deltas are finite and not negative, only the upper bound needs clamping */
+        gdouble delta = tap_info->msg_info->mean_delta * 1000.0;
 
-            default:
-                /* if we get here, there must be a bug in the dissector  */
-                DISSECTOR_ASSERT_NOT_REACHED();
-                break;
-        }
-        ptr++;
+        avg_stat_node_add_value(st, st_str_value_delta, path_node, FALSE,
+                                (delta < (gdouble)G_MAXINT) ? (gint)delta : G_MAXINT);
     }
 
-    if(offset != end)
-        return -1;
-    else
-        return 0;
+    return 1;
 }
 
-/* Dissect OSC bundle */
-static int
-dissect_osc_bundle(tvbuff_t *tvb, proto_item *ti, proto_tree *osc_tree, gint offset, gint len)
+static const gchar *st_str_overhead = "OSC/Wire Overhead";
+static const gchar *st_str_overhead_bytes = "OSC Bytes";
+static const gchar *st_str_overhead_messages = "OSC Messages";
+static int          st_node_overhead_bytes = -1;
+static int          st_node_overhead_messages = -1;
+
+static void
+osc_overhead_stats_tree_init(stats_tree *st)
 {
-    proto_tree  *bundle_tree;
-    gint         end = offset + len;
-    guint32      sec;
-    guint32      frac;
-    nstime_t     ns;
+    st_node_overhead_bytes = stats_tree_create_node(st, st_str_overhead_bytes, 0, TRUE);
+    st_node_overhead_messages = stats_tree_create_node(st, st_str_overhead_messages, 0, TRUE);
+}
 
-    /* check for valid #bundle */
-    if(tvb_strneql(tvb, offset, bundle_str, 8) != 0)
-        return -1;
+static int
+osc_overhead_stats_tree_packet(stats_tree *st, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
+{
+    const osc_tap_info_t *tap_info = (const osc_tap_info_t *)p;
+    int                   conv_node;
+    int                   path_node;
 
-    /* create bundle */
-    ti = proto_tree_add_item(osc_tree, hf_osc_bundle_type, tvb, offset, len, ENC_NA);
+    if(tap_info->type == OSC_TAP_PDU)
+    {
+        /* messages account for themselves, only add the bundle overhead */
+        if(tap_info->bundle_bytes == 0)
+            return 0;
+
+        increase_stat_node(st, st_str_overhead_bytes, 0, TRUE, tap_info->bundle_bytes);
+        conv_node = increase_stat_node(st, tap_info->conv->label, st_node_overhead_bytes, TRUE, tap_info->bundle_bytes);
+        increase_stat_node(st, "Bundle header bytes", conv_node, FALSE, tap_info->bundle_bytes);
+        return 1;
+    }
+    else if(tap_info->type != OSC_TAP_MESSAGE)
+        return 0;
 
-    bundle_tree = proto_item_add_subtree(ti, ett_osc_bundle);
+    /* byte breakdown per conversation and path */
+    increase_stat_node(st, st_str_overhead_bytes, 0, TRUE, tap_info->len);
+    conv_node = increase_stat_node(st, tap_info->conv->label, st_node_overhead_bytes, TRUE, tap_info->len);
+    path_node = increase_stat_node(st, tap_info->path, conv_node, TRUE, tap_info->len);
+    increase_stat_node(st, "Address bytes", path_node, FALSE, tap_info->address_bytes);
+    increase_stat_node(st, "Type tag bytes", path_node, FALSE, tap_info->typetag_bytes);
+    increase_stat_node(st, "Argument bytes", path_node, FALSE, tap_info->argument_bytes);
+    increase_stat_node(st, "Padding bytes", path_node, FALSE, tap_info->padding_bytes);
+
+    /* bundling efficiency per conversation and path */
+    tick_stat_node(st, st_str_overhead_messages, 0, TRUE);
+    conv_node = tick_stat_node(st, tap_info->conv->label, st_node_overhead_messages, TRUE);
+    path_node = tick_stat_node(st, tap_info->path, conv_node, TRUE);
+    tick_stat_node(st, tap_info->bundled ? "Bundled" : "Lone", path_node, FALSE);
+    if(tap_info->bundleable)
+        tick_stat_node(st, "Could have been bundled", path_node, FALSE);
+
+    return 1;
+}
 
-    offset += 8; /* skip bundle_str */
+static const gchar *st_str_seq = "OSC/Sequence Loss";
+static const gchar *st_str_seq_messages = "Expected messages";
+static int          st_node_seq_messages = -1;
 
-    /* read timetag */
-    sec  = tvb_get_ntohl(tvb, offset);
-    frac = tvb_get_ntohl(tvb, offset+4);
-    if( (sec == 0) && (frac == 1) )
-        proto_tree_add_time_format_value(bundle_tree, hf_osc_bundle_timetag_type, tvb, offset, 8, &ns, immediate_fmt, immediate_str);
-    else
-        proto_tree_add_item(bundle_tree, hf_osc_bundle_timetag_type, tvb, offset, 8, ENC_TIME_NTP | ENC_BIG_ENDIAN);
-    offset += 8;
+static void
+osc_seq_stats_tree_init(stats_tree *st)
+{
+    st_node_seq_messages = stats_tree_create_node(st, st_str_seq_messages, 0, TRUE);
+}
 
-    /* ::read size, read block:: */
-    while(offset < end)
-    {
-        /* peek bundle element size */
-        gint32 size = tvb_get_ntohl(tvb, offset);
+static int
+osc_seq_stats_tree_packet(stats_tree *st, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
+{
+    const osc_tap_info_t     *tap_info = (const osc_tap_info_t *)p;
+    const osc_message_info_t *msg_info;
+    int                       conv_node;
+    int                       path_node;
+    gint                      expected;
 
-        /* read bundle element size */
-        proto_tree_add_int_format_value(bundle_tree, hf_osc_bundle_element_size_type, tvb, offset, 4, size, "%i bytes", size);
-        offset += 4;
+    if( (tap_info->type != OSC_TAP_MESSAGE) || !tap_info->msg_info->has_seq )
+        return 0;
+    msg_info = tap_info->msg_info;
 
-        /* check for zero size bundle element */
-        if(size == 0)
-            continue;
+    /* a reordered message fills a gap counted as lost before, a duplicate was received before,
+     * so neither is expected anew */
+    expected = (msg_info->seq_reordered || msg_info->seq_duplicate) ? 0 : 1 + (gint)MIN(msg_info->seq_lost, G_MAXINT - 1);
 
-        /* peek first bundle element char */
-        switch(tvb_get_guint8(tvb, offset))
-        {
-            case '#': /* this is a bundle */
-                if(dissect_osc_bundle(tvb, ti, bundle_tree, offset, size))
-                    return -1;
-                else
-                    break;
-            case '/': /* this is a message */
-                if(dissect_osc_message(tvb, ti, bundle_tree, offset, size))
-                    return -1;
-                else
-                    break;
-            default:
-                return -1; /* neither message nor bundle */
-        }
+    increase_stat_node(st, st_str_seq_messages, 0, TRUE, expected);
+    conv_node = increase_stat_node(st, tap_info->conv->label, st_node_seq_messages, TRUE, expected);
+    path_node = increase_stat_node(st, tap_info->path, conv_node, TRUE, expected);
 
-        /* check for integer overflow */
-        if(size > G_MAXINT - offset)
-            return -1;
-        else
-            offset += size;
+    tick_stat_node(st, "Received", path_node, FALSE);
+    if(msg_info->seq_lost)
+        increase_stat_node(st, "Lost", path_node, FALSE, (gint)MIN(msg_info->seq_lost, G_MAXINT - 1));
+    if(msg_info->seq_reordered)
+    {
+        increase_stat_node(st, "Lost", path_node, FALSE, -1);
+        tick_stat_node(st, "Reordered", path_node, FALSE);
     }
+    if(msg_info->seq_duplicate)
+        tick_stat_node(st, "Duplicate", path_node, FALSE);
+    if(msg_info->seq_resync)
+        tick_stat_node(st, "Resynchronized", path_node, FALSE);
 
-    if(offset != end)
-        return -1;
-    else
-        return 0;
+    return 1;
 }
 
-/* Dissect OSC PDU */
+static const gchar *st_str_perf = "OSC/Dissector Performance";
+static const gchar *st_str_perf_entries = "Entry point calls (us)";
+static const gchar *st_str_perf_heur = "Heuristic checks";
+static const gchar *st_str_perf_bytes = "Bytes parsed";
+static const gchar *st_str_perf_elements = "Elements added to tree";
+static const gchar *st_str_perf_depth = "Bundle depth";
+static int          st_node_perf_entries = -1;
+static int          st_node_perf_heur = -1;
+
 static void
-dissect_osc_pdu_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data _U_, gint offset, gint len)
+osc_perf_stats_tree_init(stats_tree *st)
 {
-    col_set_str(pinfo->cinfo, COL_PROTOCOL, "OSC");
-    col_clear(pinfo->cinfo, COL_INFO);
-
-    if(tree) /* we are being asked for details */
-    {
-        proto_item *ti;
-        proto_tree *osc_tree;
+    st_node_perf_entries = stats_tree_create_node(st, st_str_perf_entries, 0, TRUE);
+    st_node_perf_heur = stats_tree_create_node(st, st_str_perf_heur, 0, TRUE);
+    stats_tree_create_node(st, st_str_perf_bytes, 0, FALSE);
+    stats_tree_create_node(st, st_str_perf_elements, 0, FALSE);
+}
 
-        /* create OSC packet */
-        ti = proto_tree_add_item(tree, proto_osc, tvb, 0, -1, ENC_NA);
-        osc_tree = proto_item_add_subtree(ti, ett_osc_packet);
+static int
+osc_perf_stats_tree_packet(stats_tree *st, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
+{
+    const osc_tap_info_t *tap_info = (const osc_tap_info_t *)p;
 
-        /* peek first bundle element char */
-        switch(tvb_get_guint8(tvb, offset))
-        {
-            case '#': /* this is a bundle */
-                if(dissect_osc_bundle(tvb, ti, osc_tree, offset, len))
-                    return;
-                else
-                    break;
-            case '/': /* this is a message */
-                if(dissect_osc_message(tvb, ti, osc_tree, offset, len))
-                    return;
-                else
-                    break;
-            default: /* neither message nor bundle */
-                return;
-        }
+    switch(tap_info->type)
+    {
+        case OSC_TAP_PERF:
+            tick_stat_node(st, st_str_perf_entries, 0, TRUE);
+            avg_stat_node_add_value(st, val_to_str_const(tap_info->perf_entry, osc_perf_entry_vals, "Unknown"),
+                                    st_node_perf_entries, FALSE, (gint)tap_info->perf_usec);
+            if( (tap_info->perf_entry == OSC_PERF_HEUR_UDP) || (tap_info->perf_entry == OSC_PERF_HEUR_WS) )
+            {
+                tick_stat_node(st, st_str_perf_heur, 0, TRUE);
+                tick_stat_node(st, val_to_str_const(tap_info->perf_check, osc_check_vals, "Unknown"),
+                               st_node_perf_heur, FALSE);
+            }
+            return 1;
+        case OSC_TAP_PDU:
+            increase_stat_node(st, st_str_perf_bytes, 0, FALSE, tap_info->len);
+            increase_stat_node(st, st_str_perf_elements, 0, FALSE, tap_info->elements);
+            avg_stat_node_add_value(st, st_str_perf_depth, 0, FALSE, tap_info->max_depth);
+            return 1;
+        default:
+            return 0;
     }
 }
 
-/* OSC TCP */
+/* tshark -z osc,perf */
 
-static guint
-get_osc_pdu_len(packet_info *pinfo _U_, tvbuff_t *tvb, int offset)
+typedef struct _osc_perf_stats_t {
+    guint64 calls[OSC_PERF_N];
+    gint64  usec[OSC_PERF_N];
+    gint64  max_usec[OSC_PERF_N];
+    guint64 checks[OSC_CHECK_N];
+    guint64 pdus;
+    guint64 bytes;
+    guint64 elements;
+    guint   max_depth;
+} osc_perf_stats_t;
+
+static void
+osc_perf_reset(void *tapdata)
 {
-    return tvb_get_ntohl(tvb, offset) + 4;
+    memset(tapdata, 0, sizeof(osc_perf_stats_t));
 }
 
-static int
-dissect_osc_tcp_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+static gboolean
+osc_perf_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p)
 {
-    gint pdu_len;
+    osc_perf_stats_t     *stats = (osc_perf_stats_t *)tapdata;
+    const osc_tap_info_t *tap_info = (const osc_tap_info_t *)p;
 
-    pdu_len = tvb_get_ntohl(tvb, 0);
-    dissect_osc_pdu_common(tvb, pinfo, tree, data, 4, pdu_len);
-    return pdu_len;
+    switch(tap_info->type)
+    {
+        case OSC_TAP_PERF:
+            stats->calls[tap_info->perf_entry]++;
+            stats->usec[tap_info->perf_entry] += tap_info->perf_usec;
+            if(tap_info->perf_usec > stats->max_usec[tap_info->perf_entry])
+                stats->max_usec[tap_info->perf_entry] = tap_info->perf_usec;
+            if( (tap_info->perf_entry == OSC_PERF_HEUR_UDP) || (tap_info->perf_entry == OSC_PERF_HEUR_WS) )
+                stats->checks[tap_info->perf_check]++;
+            return TRUE;
+        case OSC_TAP_PDU:
+            stats->pdus++;
+            stats->bytes += tap_info->len;
+            stats->elements += tap_info->elements;
+            if(tap_info->max_depth > stats->max_depth)
+                stats->max_depth = tap_info->max_depth;
+            return TRUE;
+        default:
+            return FALSE;
+    }
 }
 
-static int
-dissect_osc_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+static void
+osc_perf_draw(void *tapdata)
 {
-    tcp_dissect_pdus(tvb, pinfo, tree, TRUE, 4, get_osc_pdu_len,
-                     dissect_osc_tcp_pdu, data);
-    return tvb_reported_length(tvb);
+    osc_perf_stats_t *stats = (osc_perf_stats_t *)tapdata;
+    guint             i;
+
+    printf("\n");
+    printf("===================================================================\n");
+    printf("OSC Dissector Performance\n");
+    if(!global_osc_perf)
+        printf("(timing disabled, enable the osc.perf preference)\n");
+    printf("%-24s %12s %14s %10s %10s\n", "Entry point", "Calls", "Total (us)", "Mean (us)", "Max (us)");
+    for(i=0; i<OSC_PERF_N; i++)
+        printf("%-24s %12" G_GINT64_MODIFIER "u %14" G_GINT64_MODIFIER "d %10.2f %10" G_GINT64_MODIFIER "d\n",
+               val_to_str_const(i, osc_perf_entry_vals, "Unknown"),
+               stats->calls[i], stats->usec[i],
+               stats->calls[i] ? (gdouble)stats->usec[i] / stats->calls[i] : 0.0,
+               stats->max_usec[i]);
+    printf("\nHeuristic checks\n");
+    for(i=0; i<OSC_CHECK_N; i++)
+        printf("  %-40s %12" G_GINT64_MODIFIER "u\n",
+               val_to_str_const(i, osc_check_vals, "Unknown"), stats->checks[i]);
+    printf("\nPDUs: %" G_GINT64_MODIFIER "u, bytes parsed: %" G_GINT64_MODIFIER "u, "
+           "elements added to tree: %" G_GINT64_MODIFIER "u, maximal bundle depth: %u\n",
+           stats->pdus, stats->bytes, stats->elements, stats->max_depth);
+    printf("===================================================================\n");
 }
 
-/* OSC UDP */
+static void
+osc_perf_init(const char *opt_arg _U_, void *userdata _U_)
+{
+    osc_perf_stats_t *stats;
+    GString          *error_string;
+
+    stats = g_new0(osc_perf_stats_t, 1);
+
+    error_string = register_tap_listener("osc", stats, NULL, 0,
+                                         osc_perf_reset, osc_perf_packet, osc_perf_draw);
+    if(error_string)
+    {
+        fprintf(stderr, "tshark: Couldn't register osc,perf tap: %s\n", error_string->str);
+        g_string_free(error_string, TRUE);
+        g_free(stats);
+        exit(1);
+    }
+}
+
+static const gchar *st_str_ns = "OSC/Namespace";
+static const gchar *st_str_ns_messages = "OSC Messages";
+static int          st_node_ns_messages = -1;
+static gboolean     st_ns_complete = FALSE;
+
+static void
+osc_ns_stats_tree_init(stats_tree *st)
+{
+    /* a namespace present before this run is complete, else it is built while the view is tapping */
+    st_ns_complete = (osc_namespace != NULL);
+    osc_ns_requested = TRUE;
+
+    st_node_ns_messages = stats_tree_create_node(st, st_str_ns_messages, 0, TRUE);
+}
 
 static int
-dissect_osc_udp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+osc_ns_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p)
 {
-    gint pdu_len;
+    const osc_tap_info_t     *tap_info = (const osc_tap_info_t *)p;
+    const osc_ns_node_t      *node;
+    const osc_ns_signature_t *sig;
+    gchar                    *segment;
+    gchar                    *next;
+    int                       parent;
+    guint                     i;
+
+    if( (tap_info->type != OSC_TAP_MESSAGE) || !tap_info->msg_info->ns_node )
+        return 0;
+    node = tap_info->msg_info->ns_node;
+    sig = tap_info->msg_info->ns_signature;
 
-    pdu_len = tvb_reported_length(tvb);
-    dissect_osc_pdu_common(tvb,pinfo, tree, data, 0, pdu_len);
-    return pdu_len;
+    /* one node per path segment, counting the messages below */
+    parent = tick_stat_node(st, st_str_ns_messages, 0, TRUE);
+    segment = wmem_strdup(wmem_packet_scope(), tap_info->path + 1);
+    for(;;)
+    {
+        if( (next = strchr(segment, '/')) )
+            *next = '\0';
+        parent = tick_stat_node(st, segment, parent, TRUE);
+        if(!next)
+            break;
+        segment = next + 1;
+    }
+
+    /* frames and ranges are added once, last frames and ranges are only known for a complete namespace */
+    if(pinfo->fd->num == node->first_frame)
+        tick_stat_node(st, wmem_strdup_printf(wmem_packet_scope(), "First frame %u", node->first_frame), parent, FALSE);
+    if(st_ns_complete && (pinfo->fd->num == node->last_frame))
+        tick_stat_node(st, wmem_strdup_printf(wmem_packet_scope(), "Last frame %u", node->last_frame), parent, FALSE);
+
+    parent = tick_stat_node(st, sig->format, parent, TRUE);
+    if( st_ns_complete && (pinfo->fd->num == sig->last_frame) && sig->has_values )
+        for(i=0; i<sig->n_values; i++)
+            tick_stat_node(st, wmem_strdup_printf(wmem_packet_scope(), "Argument %u: %g .. %g",
+                           i, sig->ranges[i].min, sig->ranges[i].max), parent, FALSE);
+
+    return 1;
 }
 
-/* UDP Heuristic */
+/* tshark -z osc,namespace */
+
 static gboolean
-dissect_osc_heur_udp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+osc_ns_print_signature(void *value, void *userdata)
 {
-    conversation_t *conversation;
+    const osc_ns_signature_t *sig = (const osc_ns_signature_t *)value;
+    guint                     level = GPOINTER_TO_UINT(userdata);
+    guint                     i;
 
-		/*
-    if(tvb_captured_length(tvb) < 8)
-        return FALSE;
-		*/
+    printf("%*s%-24s %12u", level * 2, "", sig->format, sig->count);
+    if(sig->has_values)
+        for(i=0; i<sig->n_values; i++)
+            printf(" [%g .. %g]", sig->ranges[i].min, sig->ranges[i].max);
+    printf("\n");
 
-    /* peek first string */
-    if(tvb_strneql(tvb, 0, bundle_str, 8) != 0) /* no OSC bundle */
-    {
-        gint         offset = 0;
-        gint         slen;
-        gint         rem;
-        const gchar *str;
-        gboolean     valid  = FALSE;
+    return FALSE;
+}
 
-        /* Check for valid path */
-        /* Don't propagate any exceptions upwards during heuristics check  */
-        /* XXX: this check is a bit expensive; Consider: use UDP port pref ? */
-        TRY {
-            str = tvb_get_const_stringz(tvb, offset, &slen);
-            if(is_valid_path(str)) {
+static gboolean
+osc_ns_print_node(void *value, void *userdata)
+{
+    const osc_ns_node_t *node = (const osc_ns_node_t *)value;
+    guint                level = GPOINTER_TO_UINT(userdata);
 
-                /* skip path */
-                if( (rem = slen%4) ) slen += 4-rem;
-                offset += slen;
+    if(node->count)
+        printf("%*s/%-*s %12u %10u %10u\n", level * 2, "", (gint)MAX(0, 36 - (gint)level * 2), node->name,
+               node->count, node->first_frame, node->last_frame);
+    else
+        printf("%*s/%s\n", level * 2, "", node->name);
 
-                /* peek next string */
-                str = tvb_get_const_stringz(tvb, offset, &slen);
+    if(node->signatures)
+        wmem_tree_foreach(node->signatures, osc_ns_print_signature, GUINT_TO_POINTER(level + 2));
+    if(node->children)
+        wmem_tree_foreach(node->children, osc_ns_print_node, GUINT_TO_POINTER(level + 1));
 
-                /* check for valid format */
-                if(is_valid_format(str))
-                    valid = TRUE;
-            }
-        }
-        CATCH_ALL {
-            valid = FALSE;
-        }
-        ENDTRY;
+    return FALSE;
+}
 
-        if(! valid)
-            return FALSE;
-    }
+static gboolean
+osc_ns_packet(void *tapdata _U_, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *p _U_)
+{
+    /* the namespace is built by the dissector itself */
+    return FALSE;
+}
 
-    /* if we get here, then it's an Open Sound Control packet (bundle or message) */
+static void
+osc_ns_draw(void *tapdata _U_)
+{
+    printf("\n");
+    printf("===================================================================\n");
+    printf("OSC Namespace\n");
+    printf("%-37s %12s %10s %10s\n", "Path", "Messages", "First", "Last");
+    if(osc_namespace && osc_namespace->children)
+        wmem_tree_foreach(osc_namespace->children, osc_ns_print_node, GUINT_TO_POINTER(0));
+    printf("===================================================================\n");
+}
 
-    /* specify that dissect_osc is to be called directly from now on for packets for this connection */
-    conversation = find_or_create_conversation(pinfo);
-    conversation_set_dissector(conversation, osc_udp_handle);
+static void
+osc_ns_init(const char *opt_arg _U_, void *userdata _U_)
+{
+    GString *error_string;
 
-    /* do the dissection */
-    dissect_osc_udp(tvb, pinfo, tree, data);
+    /* collect the namespace during the first pass, without the preference */
+    osc_ns_requested = TRUE;
 
-    return TRUE; /* OSC heuristics was matched */
+    error_string = register_tap_listener("osc", &osc_namespace, NULL, 0,
+                                         NULL, osc_ns_packet, osc_ns_draw);
+    if(error_string)
+    {
+        fprintf(stderr, "tshark: Couldn't register osc,namespace tap: %s\n", error_string->str);
+        g_string_free(error_string, TRUE);
+        exit(1);
+    }
 }
 
 /* Register the protocol with Wireshark */
@@ -722,6 +2859,47 @@ void
 proto_register_osc(void)
 {
     static hf_register_info hf[] = {
+        { &hf_osc_duplicate_of_type, { "Duplicate of", "osc.duplicate_of",
+                FT_FRAMENUM, BASE_NONE,
+                NULL, 0x0,
+                "Frame this PDU is an exact duplicate of", HFILL } },
+        { &hf_osc_unchanged_type, { "Unchanged", "osc.unchanged",
+                FT_BOOLEAN, BASE_NONE,
+                NULL, 0x0,
+                "Arguments equal those of the previous message with the same path", HFILL } },
+        { &hf_osc_seq_type, { "Sequence number", "osc.seq",
+                FT_INT64, BASE_DEC,
+                NULL, 0x0,
+                "Sequence number argument as configured in the sequence number table", HFILL } },
+        { &hf_osc_seq_lost_type, { "Lost", "osc.seq.lost",
+                FT_UINT32, BASE_DEC,
+                NULL, 0x0,
+                "Number of sequence numbers skipped before this message", HFILL } },
+        { &hf_osc_seq_reordered_type, { "Reordered", "osc.seq.reordered",
+                FT_BOOLEAN, BASE_NONE,
+                NULL, 0x0,
+                "Late sequence number filling a gap counted as lost before", HFILL } },
+        { &hf_osc_seq_duplicate_type, { "Duplicate", "osc.seq.duplicate",
+                FT_BOOLEAN, BASE_NONE,
+                NULL, 0x0,
+                "Sequence number received before, or too old to be remembered as missing", HFILL } },
+        { &hf_osc_seq_resync_type, { "Resynchronized", "osc.seq.resync",
+                FT_BOOLEAN, BASE_NONE,
+                NULL, 0x0,
+                "Sequence number jumped back beyond the resync limit, tracking starts over", HFILL } },
+        { &hf_osc_sampling_skipped_type, { "Skipped", "osc.sampling.skipped",
+                FT_UINT32, BASE_DEC,
+                NULL, 0x0,
+                "Messages of the same path not dissected since the previous sampled one", HFILL } },
+        { &hf_osc_ns_first_frame_type, { "First message to path", "osc.namespace.first_frame",
+                FT_FRAMENUM, BASE_NONE,
+                NULL, 0x0,
+                "Frame of the first message to this path in the capture", HFILL } },
+        { &hf_osc_ns_last_frame_type, { "Last message to path", "osc.namespace.last_frame",
+                FT_FRAMENUM, BASE_NONE,
+                NULL, 0x0,
+                "Frame of the last message to this path in the capture", HFILL } },
+
         { &hf_osc_bundle_type, { "Bundle", "osc.bundle",
                 FT_NONE, BASE_NONE,
                 NULL, 0x0,
@@ -767,17 +2945,21 @@ proto_register_osc(void)
                 "String value", HFILL } },
 
         { &hf_osc_message_blob_type, { "Blob", "osc.message.blob",
-                FT_NONE, BASE_NONE,
-                NULL, 0x0,
+                FT_INT32, BASE_CUSTOM,
+                CF_FUNC(osc_fmt_blob_size), 0x0,
                 "Binary blob value", HFILL } },
         { &hf_osc_message_blob_size_type, { "Size", "osc.message.blob.size",
-                FT_INT32, BASE_DEC,
-                NULL, 0x0,
+                FT_INT32, BASE_CUSTOM,
+                CF_FUNC(osc_fmt_blob_size), 0x0,
                 "Binary blob size", HFILL } },
         { &hf_osc_message_blob_data_type, { "Data", "osc.message.blob.data",
                 FT_BYTES, BASE_NONE,
                 NULL, 0x0,
                 "Binary blob data", HFILL } },
+        { &hf_osc_message_blob_hash_type, { "Hash", "osc.message.blob.hash",
+                FT_UINT64, BASE_HEX,
+                NULL, 0x0,
+                "FNV-1a hash of binary blob data exceeding the display limit", HFILL } },
 
         { &hf_osc_message_true_type, { "True", "osc.message.true",
                 FT_NONE, BASE_NONE,
@@ -840,8 +3022,8 @@ proto_register_osc(void)
                 "Alpha transparency component", HFILL } },
 
         { &hf_osc_message_midi_type, { "MIDI", "osc.message.midi",
-                FT_NONE, BASE_NONE,
-                NULL, 0x0,
+                FT_UINT32, BASE_CUSTOM,
+                CF_FUNC(osc_fmt_midi), 0x0,
                 "MIDI value", HFILL } },
         { &hf_osc_message_midi_channel_type, { "Channel", "osc.message.midi.channel",
                 FT_UINT8, BASE_DEC,
@@ -866,7 +3048,16 @@ proto_register_osc(void)
         { &hf_osc_message_midi_value_type, { "Value", "osc.message.midi.value",
                 FT_UINT8, BASE_HEX,
                 NULL, 0x0,
-                "MIDI controller value", HFILL } }
+                "MIDI controller value", HFILL } },
+
+        { &hf_osc_message_array_type, { "Array", "osc.message.array",
+                FT_NONE, BASE_NONE,
+                NULL, 0x0,
+                "Array of arguments", HFILL } },
+        { &hf_osc_message_undecoded_type, { "Undecoded arguments", "osc.message.undecoded",
+                FT_BYTES, BASE_NONE,
+                NULL, 0x0,
+                "Arguments following an unknown type tag or a string longer than the scan limit", HFILL } }
     };
 
     /* Setup protocol subtree array */
@@ -877,22 +3068,181 @@ proto_register_osc(void)
         &ett_osc_message_header,
         &ett_osc_blob,
         &ett_osc_rgba,
-        &ett_osc_midi
+        &ett_osc_midi,
+        &ett_osc_array
+    };
+
+    static ei_register_info ei[] = {
+        { &ei_osc_duplicate, { "osc.expert.duplicate", PI_SEQUENCE, PI_NOTE,
+                "Duplicate PDU", EXPFILL } },
+        { &ei_osc_seq_gap, { "osc.expert.seq_gap", PI_SEQUENCE, PI_WARN,
+                "Sequence gap", EXPFILL } },
+        { &ei_osc_seq_reordered, { "osc.expert.seq_reordered", PI_SEQUENCE, PI_NOTE,
+                "Sequence number out of order", EXPFILL } },
+        { &ei_osc_seq_duplicate, { "osc.expert.seq_duplicate", PI_SEQUENCE, PI_NOTE,
+                "Sequence number repeated", EXPFILL } },
+        { &ei_osc_seq_resync, { "osc.expert.seq_resync", PI_SEQUENCE, PI_WARN,
+                "Sequence number reset, tracking resynchronized", EXPFILL } },
+        { &ei_osc_blob_size, { "osc.expert.blob_size", PI_MALFORMED, PI_ERROR,
+                "Blob size exceeds message", EXPFILL } },
+        { &ei_osc_string_size, { "osc.expert.string_size", PI_MALFORMED, PI_ERROR,
+                "String not terminated within message", EXPFILL } },
+        { &ei_osc_unknown_tag, { "osc.expert.unknown_tag", PI_UNDECODED, PI_NOTE,
+                "Unknown type tag", EXPFILL } },
+        { &ei_osc_string_limit, { "osc.expert.string_limit", PI_UNDECODED, PI_NOTE,
+                "String longer than the scan limit, remaining arguments not dissected", EXPFILL } }
+    };
+
+    static uat_field_t osc_seq_uat_fields[] = {
+        UAT_FLD_CSTRING(osc_seq_uats, pattern, "Address pattern",
+                "Message path, may contain the wildcards '*' and '?'"),
+        UAT_FLD_DEC(osc_seq_uats, arg_index, "Argument index",
+                "Zero based index of the int32 or int64 argument carrying the sequence number"),
+        UAT_END_FIELDS
     };
 
-    module_t *osc_module;
+    uat_t           *osc_seq_uat;
+
+    module_t        *osc_module;
+    expert_module_t *expert_osc;
 
     proto_osc = proto_register_protocol("Open Sound Control Protocol", "OSC", "osc");
 
+    osc_init_midi_names();
+
     proto_register_field_array(proto_osc, hf, array_length(hf));
     proto_register_subtree_array(ett, array_length(ett));
 
+    expert_osc = expert_register_protocol(proto_osc);
+    expert_register_field_array(expert_osc, ei, array_length(ei));
+
+    osc_tap = register_tap("osc");
+
+    register_init_routine(osc_namespace_init);
+
+    /* "osc" is the name exported PDUs are tagged with */
+    osc_udp_handle = new_register_dissector("osc", dissect_osc_udp, proto_osc);
+
     osc_module = prefs_register_protocol(proto_osc, proto_reg_handoff_osc);
 
     prefs_register_uint_preference(osc_module, "tcp.port",
                                    "OSC TCP Port",
                                    "Set the TCP port for OSC",
                                    10, &global_osc_tcp_port);
+
+    prefs_register_bool_preference(osc_module, "detect_duplicates",
+                                   "Detect duplicate PDUs",
+                                   "Flag PDUs that exactly repeat a recent PDU of the same sender within the duplicate interval",
+                                   &global_osc_dup_detect);
+
+    prefs_register_uint_preference(osc_module, "duplicate_window",
+                                   "Duplicate detection window",
+                                   "Number of recent PDUs per conversation and direction to compare against (at most 256)",
+                                   10, &global_osc_dup_window);
+
+    prefs_register_uint_preference(osc_module, "duplicate_interval",
+                                   "Duplicate interval (ms)",
+                                   "Repeats further apart than this are not duplicates",
+                                   10, &global_osc_dup_interval);
+
+    prefs_register_bool_preference(osc_module, "value_analysis",
+                                   "Analyze value changes",
+                                   "Compare the arguments of each message with the previous message of the same path",
+                                   &global_osc_value_analysis);
+
+    prefs_register_bool_preference(osc_module, "namespace",
+                                   "Build address namespace",
+                                   "Collect all message paths of the capture with their type signatures and value ranges, "
+                                   "see Statistics > OSC > Namespace and tshark -z osc,namespace",
+                                   &global_osc_namespace);
+
+    prefs_register_uint_preference(osc_module, "bundle_window",
+                                   "Bundling window (ms)",
+                                   "PDUs of the same sender arriving within this time could have shared one datagram (0 to disable)",
+                                   10, &global_osc_bundle_window);
+
+    prefs_register_uint_preference(osc_module, "blob_max_bytes",
+                                   "Maximum blob bytes shown",
+                                   "Larger blobs are shown truncated with their size and hash (0 for no limit)",
+                                   10, &global_osc_blob_max_bytes);
+
+    prefs_register_uint_preference(osc_module, "string_max_len",
+                                   "Maximum string length",
+                                   "Strings are scanned for their terminator up to this length, "
+                                   "the arguments from a longer string on are not dissected (0 for no limit)",
+                                   10, &global_osc_string_max_len);
+
+    prefs_register_uint_preference(osc_module, "array_max_depth",
+                                   "Maximum array nesting",
+                                   "Messages with arrays nested deeper are not accepted as OSC (at most 32)",
+                                   10, &global_osc_array_max_depth);
+
+    prefs_register_bool_preference(osc_module, "unknown_tags",
+                                   "Accept unknown type tags",
+                                   "Accept messages with unknown type tags, the arguments from the first unknown type tag on are not dissected",
+                                   &global_osc_unknown_tags);
+
+    prefs_register_enum_preference(osc_module, "sampling",
+                                   "Sampling mode",
+                                   "Only fully dissect a sample of the messages of each conversation and path, "
+                                   "the others are dissected up to their path",
+                                   &global_osc_sampling, osc_sampling_vals, FALSE);
+
+    prefs_register_uint_preference(osc_module, "sampling_count",
+                                   "Sampling count",
+                                   "Fully dissect every Nth message per path",
+                                   10, &global_osc_sampling_count);
+
+    prefs_register_uint_preference(osc_module, "sampling_interval",
+                                   "Sampling interval (ms)",
+                                   "Fully dissect one message per path within this interval",
+                                   10, &global_osc_sampling_interval);
+
+    prefs_register_uint_preference(osc_module, "heuristic_threshold",
+                                   "Heuristic confirmation packets",
+                                   "Number of consecutive valid OSC packets before a UDP conversation is bound to OSC",
+                                   10, &global_osc_heur_threshold);
+
+    prefs_register_uint_preference(osc_module, "heuristic_max_failures",
+                                   "Heuristic failure limit",
+                                   "Number of accumulated invalid packets after which a bound UDP conversation is released (0 to never release)",
+                                   10, &global_osc_heur_max_failures);
+
+    prefs_register_uint_preference(osc_module, "ws.port",
+                                   "OSC WebSocket Port",
+                                   "WebSocket payloads on this TCP port are dissected as OSC without heuristic confirmation (0 to disable)",
+                                   10, &global_osc_ws_port);
+
+    prefs_register_bool_preference(osc_module, "perf",
+                                   "Performance instrumentation",
+                                   "Time the OSC entry points and count heuristic results, "
+                                   "see Statistics > OSC > Dissector Performance and tshark -z osc,perf",
+                                   &global_osc_perf);
+
+    osc_seq_uat = uat_new("OSC Sequence Numbers",
+                          sizeof(osc_seq_uat_t),
+                          "osc_sequence_numbers",
+                          TRUE,
+                          (void **)&osc_seq_uats,
+                          &num_osc_seq_uats,
+                          UAT_AFFECTS_DISSECTION,
+                          NULL,
+                          osc_seq_uat_copy_cb,
+                          osc_seq_uat_update_cb,
+                          osc_seq_uat_free_cb,
+                          osc_seq_uat_post_update_cb,
+                          osc_seq_uat_fields);
+
+    prefs_register_uat_preference(osc_module, "sequence_numbers",
+                                  "Sequence numbers",
+                                  "Messages carrying a sequence number argument",
+                                  osc_seq_uat);
+
+    prefs_register_uint_preference(osc_module, "sequence_resync",
+                                   "Sequence resync distance",
+                                   "A sequence number this far below the expected one, and not filling a gap, "
+                                   "restarts tracking (0 to never resynchronize)",
+                                   10, &global_osc_seq_resync);
 }
 
 void
@@ -909,10 +3259,14 @@ proto_reg_handoff_osc(void)
 
         /* XXX: Add port pref and  "decode as" for UDP ? */
         /*      (The UDP heuristic is a bit expensive    */
-        osc_udp_handle = new_create_dissector_handle(dissect_osc_udp, proto_osc);
         /* register as heuristic dissector for UDP connections */
         heur_dissector_add("udp", dissect_osc_heur_udp, proto_osc);
 
+        /* register as heuristic dissector for WebSocket payloads */
+        heur_dissector_add("ws", dissect_osc_heur_ws, proto_osc);
+
+        exported_pdu_tap = find_tap_id(EXPORT_PDU_TAP_NAME_LAYER_7);
+
         initialized = TRUE;
     }
     else
@@ -954,4 +3308,24 @@ plugin_reg_handoff(void)
 {
     proto_reg_handoff_osc();
 }
+
+void
+plugin_register_tap_listener(void)
+{
+    stats_tree_register_plugin("osc", "osc_dup", st_str_dup, 0,
+                               osc_dup_stats_tree_packet, osc_dup_stats_tree_init, NULL);
+    stats_tree_register_plugin("osc", "osc_value", st_str_value, 0,
+                               osc_value_stats_tree_packet, osc_value_stats_tree_init, NULL);
+    stats_tree_register_plugin("osc", "osc_overhead", st_str_overhead, 0,
+                               osc_overhead_stats_tree_packet, osc_overhead_stats_tree_init, NULL);
+    stats_tree_register_plugin("osc", "osc_seq", st_str_seq, 0,
+                               osc_seq_stats_tree_packet, osc_seq_stats_tree_init, NULL);
+    stats_tree_register_plugin("osc", "osc_perf", st_str_perf, 0,
+                               osc_perf_stats_tree_packet, osc_perf_stats_tree_init, NULL);
+    stats_tree_register_plugin("osc", "osc_ns", st_str_ns, 0,
+                               osc_ns_stats_tree_packet, osc_ns_stats_tree_init, NULL);
+
+    register_stat_cmd_arg("osc,perf", osc_perf_init, NULL);
+    register_stat_cmd_arg("osc,namespace", osc_ns_init, NULL);
+}
 #endif